@@ -58,3 +58,114 @@
 #ifndef CHIP_DEVICE_CONFIG_DEVICE_CONFIGURATION_VERSION
 #define CHIP_DEVICE_CONFIG_DEVICE_CONFIGURATION_VERSION 1
 #endif
+
+// Event logging buffers. Critical holds StartUp/BootReason style events, Info carries the
+// soil threshold-crossing events and Debug is kept small since nothing logs at that level.
+#ifndef CHIP_DEVICE_CONFIG_EVENT_LOGGING_CRIT_BUFFER_SIZE
+#define CHIP_DEVICE_CONFIG_EVENT_LOGGING_CRIT_BUFFER_SIZE 512
+#endif
+
+#ifndef CHIP_DEVICE_CONFIG_EVENT_LOGGING_INFO_BUFFER_SIZE
+#define CHIP_DEVICE_CONFIG_EVENT_LOGGING_INFO_BUFFER_SIZE 1024
+#endif
+
+#ifndef CHIP_DEVICE_CONFIG_EVENT_LOGGING_DEBUG_BUFFER_SIZE
+#define CHIP_DEVICE_CONFIG_EVENT_LOGGING_DEBUG_BUFFER_SIZE 256
+#endif
+
+// The event-number counter is persisted once per epoch; after a reboot numbering resumes at
+// the next epoch boundary so numbers never repeat and subscribers keep their event filters.
+#ifndef CHIP_DEVICE_CONFIG_EVENT_ID_COUNTER_EPOCH
+#define CHIP_DEVICE_CONFIG_EVENT_ID_COUNTER_EPOCH 0x1000
+#endif
+
+// Session resumption records: the SDK default of three per fabric, matching the minimum number of
+// CASE sessions per fabric the spec requires. The default storage re-saves a record on every resumed
+// handshake and evicts the oldest one when full, so this behaves as an LRU.
+#ifndef CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE
+#define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE (3 * CONFIG_CHIP_MAX_FABRICS)
+#endif
+
+// Persisted subscriptions (CONFIG_CHIP_PERSISTENT_SUBSCRIPTIONS) are resumed by the device after a
+// reboot. The first attempt usually races Wi-Fi association, so retry after seconds rather than the
+// SDK's five-minute default, backing off along a Fibonacci curve capped at one hour.
+#ifndef CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_MIN_RETRY_INTERVAL_SECS
+#define CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_MIN_RETRY_INTERVAL_SECS 5
+#endif
+
+#ifndef CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_WAIT_TIME_MULTIPLIER_SECS
+#define CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_WAIT_TIME_MULTIPLIER_SECS 10
+#endif
+
+#ifndef CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_MAX_RETRY_INTERVAL_SECS
+#define CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_MAX_RETRY_INTERVAL_SECS 3600
+#endif
+
+// Let the app retune the advertised MRP intervals at runtime from the ACK round-trip times reported
+// through the MRP analytics hook (see matter/adaptive_mrp.h).
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG
+#define CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG 1
+#endif
+
+#ifndef CHIP_CONFIG_MRP_ANALYTICS_ENABLED
+#define CHIP_CONFIG_MRP_ANALYTICS_ENABLED 1
+#endif
+
+// ICD builds stay in idle mode for one sampling interval, never less than the slow poll period; the
+// soil sensor's own activity ends each idle period anyway.
+#if defined(CONFIG_CHIP_ENABLE_ICD_SUPPORT) && !defined(CHIP_CONFIG_ICD_IDLE_MODE_DURATION_SEC)
+#if CONFIG_SOIL_SAMPLE_INTERVAL_MS > CONFIG_CHIP_ICD_SLOW_POLL_INTERVAL
+#define CHIP_CONFIG_ICD_IDLE_MODE_DURATION_SEC ((CONFIG_SOIL_SAMPLE_INTERVAL_MS + 999) / 1000)
+#else
+#define CHIP_CONFIG_ICD_IDLE_MODE_DURATION_SEC ((CONFIG_CHIP_ICD_SLOW_POLL_INTERVAL + 999) / 1000)
+#endif
+#endif
+
+// Per-transaction objects come from fixed pools sized from the fabric limit instead of the CHIP
+// heap: exchanges and read handlers from the SDK's static ObjectPools (bitmap allocation, no heap
+// traffic) and, with CONFIG_SOIL_PACKET_BUFFER_POOL, packet buffers from a static pool.
+// Subscriptions follow the spec minimum of three per fabric, reads one per fabric plus one for
+// commissioning. Exchanges cover every read and report in flight plus one CASE or invoke exchange
+// per fabric. Usage, watermarks and refused allocations are reported by diag/pool_stats.h.
+#ifndef CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_SYSTEM_CONFIG_POOL_USE_HEAP 0
+#endif
+
+#ifndef CHIP_IM_MAX_NUM_SUBSCRIPTIONS
+#define CHIP_IM_MAX_NUM_SUBSCRIPTIONS (3 * CONFIG_CHIP_MAX_FABRICS)
+#endif
+
+#ifndef CHIP_IM_MAX_NUM_READS
+#define CHIP_IM_MAX_NUM_READS (CONFIG_CHIP_MAX_FABRICS + 1)
+#endif
+
+#ifndef CHIP_IM_MAX_REPORTS_IN_FLIGHT
+#define CHIP_IM_MAX_REPORTS_IN_FLIGHT 4
+#endif
+
+#ifndef CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
+#define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS (CHIP_IM_MAX_NUM_READS + CHIP_IM_MAX_REPORTS_IN_FLIGHT + CONFIG_CHIP_MAX_FABRICS)
+#endif
+
+// Packet buffers: one per report in flight, one inbound message per fabric, two for minimal mDNS
+// (a query being parsed while its response is built) and, with BLE commissioning, three for BTP
+// (reassembly, the send queue and a standalone ack). The pool is carved out of the CHIP heap
+// budget: configurations that enable it shrink CONFIG_CHIP_MALLOC_SYS_HEAP_SIZE to match, and
+// the others keep the platform's heap-backed buffers.
+#if defined(CONFIG_SOIL_PACKET_BUFFER_POOL)
+#if defined(CONFIG_BT)
+#define SOIL_BTP_PACKET_BUFFERS 3
+#else
+#define SOIL_BTP_PACKET_BUFFERS 0
+#endif
+
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE                                                                                  \
+    (CHIP_IM_MAX_REPORTS_IN_FLIGHT + CONFIG_CHIP_MAX_FABRICS + 2 + SOIL_BTP_PACKET_BUFFERS)
+#endif
+#endif
+
+// In-use counts and high watermarks for packet buffers and exchanges (chip::System::Stats).
+#ifndef CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+#define CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS 1
+#endif
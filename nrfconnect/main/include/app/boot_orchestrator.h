@@ -0,0 +1,42 @@
+#pragma once
+
+#include "diag/boot_timeline.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace app
+{
+namespace boot_orchestrator
+{
+
+// Runs boot steps on the calling thread, each as soon as its dependencies are met, in declaration
+// order among the ready ones. The steps touch the CHIP stack, which is single-threaded until the
+// event loop starts. Each step is timed into the boot timeline.
+
+struct Step
+{
+    const char * name;
+    uint32_t dependsOn; // bitmask of step indices, see DependsOn()
+    diag::boot_timeline::Phase phase;
+    bool (*run)(); // returning false aborts the boot
+};
+
+constexpr size_t kMaxSteps = 16;
+
+constexpr uint32_t DependsOn()
+{
+    return 0;
+}
+
+template <typename... Rest>
+constexpr uint32_t DependsOn(uint8_t index, Rest... rest)
+{
+    return (1u << index) | DependsOn(rest...);
+}
+
+// Returns once every step has run. Returns false if a step failed or the graph cannot complete.
+bool Run(const Step * steps, size_t count);
+
+} // namespace boot_orchestrator
+} // namespace app
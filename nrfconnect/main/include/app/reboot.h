@@ -0,0 +1,21 @@
+#pragma once
+
+#include <platform/CHIPDeviceLayer.h>
+
+namespace app
+{
+namespace reboot
+{
+
+// Resets other than a factory reset flush the settings write-back cache (cfg/settings_writeback.h)
+// first, so deferred session resumption, subscription and Last Known Good Time records survive:
+// - an OTA image being applied, which the SDK reboots into shortly after kOtaApplyInProgress;
+// - fatal errors, with CONFIG_SOIL_FATAL_ERROR_REBOOT, which replaces the NCS reset-on-fatal-error
+//   handler. A fault in a thread aborts that thread and reboots from the system work queue after the
+//   flush; a fault in an ISR or a kernel panic reboots at once.
+// A factory reset discards the cache instead (app/factory_reset.h).
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+} // namespace reboot
+} // namespace app
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cfg
+{
+namespace config_cache
+{
+
+// RAM copy of the configuration values served on Basic Information reads. Each value is read
+// from persistent storage once, at Populate() or on first use after it was invalidated, and the
+// lookup result (including "not provisioned") is kept until the value is stored or invalidated.
+// The getters mirror the ConfigurationManager / DeviceInstanceInfoProvider signatures.
+
+struct Stats
+{
+    uint32_t hits;
+    uint32_t loads; // reads that went to persistent storage
+    uint32_t invalidations;
+};
+
+// Loads every cached value; call once the settings subsystem is up.
+void Populate();
+
+CHIP_ERROR GetUniqueId(char * buf, size_t bufSize);
+CHIP_ERROR GetConfigurationVersion(uint32_t & configurationVersion);
+CHIP_ERROR GetCountryCode(char * buf, size_t bufSize, size_t & codeLen);
+CHIP_ERROR GetManufacturingDate(uint16_t & year, uint8_t & month, uint8_t & day);
+CHIP_ERROR GetSerialNumber(char * buf, size_t bufSize);
+CHIP_ERROR GetHardwareVersion(uint16_t & hardwareVersion);
+
+// Write through to persistent storage and refresh the cached copy.
+CHIP_ERROR StoreCountryCode(const char * code, size_t codeLen);
+CHIP_ERROR StoreManufacturingDate(const char * date, size_t dateLen);
+
+// For values changed behind the cache's back (Location writes, SetRegulatoryConfig).
+void InvalidateCountryCode();
+void InvalidateAll();
+
+Stats GetStats();
+
+} // namespace config_cache
+} // namespace cfg
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cfg
+{
+namespace settings_writeback
+{
+
+// Write-back layer in front of the settings/NVS backend. Repeated writes to the same key
+// within CONFIG_SOIL_SETTINGS_WRITEBACK_WINDOW_MS are coalesced in RAM and flushed as one
+// batch, cutting NVS write amplification. Anything pending must be flushed with FlushNow()
+// before a reset (app/reboot.h covers OTA apply and fatal errors), or dropped with Discard() when
+// the storage is about to be wiped.
+
+struct KeyStats
+{
+    char key[chip::PersistentStorageDelegate::kKeyLengthMax + 1];
+    uint32_t requestedWrites;
+    uint32_t requestedBytes;
+    uint32_t flashWrites;
+    uint32_t flashBytes;
+};
+
+struct Stats
+{
+    uint32_t requestedWrites;
+    uint32_t coalescedWrites;
+    uint32_t flashWrites;
+    uint32_t flashBytes;
+    uint32_t flushes;
+    uint32_t writeThroughs;
+};
+
+void Init();
+
+// Deferred write to a raw Zephyr settings key. Values larger than
+// CONFIG_SOIL_SETTINGS_WRITEBACK_MAX_VALUE_SIZE, or arriving with every slot taken, are written through.
+int Write(const char * key, const void * data, size_t len);
+int Delete(const char * key);
+
+void FlushNow();
+void Discard();
+// For the fatal error path, off the CHIP thread: writes the pending raw settings values and drops
+// the Matter ones, which need the CHIP thread. Writes nothing if the write-back or NVS lock is
+// held, since the faulting thread may have died holding it.
+void FlushAfterFault();
+
+Stats GetStats();
+size_t GetKeyStats(KeyStats * out, size_t maxCount);
+void LogStats();
+
+// PersistentStorageDelegate handed to the Matter server. Keys that churn at runtime but can be
+// lost on power failure without compromising security (session resumption, subscriptions,
+// Last Known Good Time) are deferred; everything else passes straight through to `inner`.
+class WriteBackStorageDelegate final : public chip::PersistentStorageDelegate
+{
+public:
+    explicit WriteBackStorageDelegate(chip::PersistentStorageDelegate & inner);
+
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override;
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override;
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override;
+
+    chip::PersistentStorageDelegate & Inner() { return *mInner; }
+
+private:
+    chip::PersistentStorageDelegate * mInner;
+};
+
+} // namespace settings_writeback
+} // namespace cfg
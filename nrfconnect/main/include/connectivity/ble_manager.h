@@ -2,15 +2,46 @@
 
 #include <platform/CHIPDeviceLayer.h>
 
+#include <cstdint>
+
 namespace connectivity
 {
 namespace ble_manager
 {
 
+// Commissioning advertising follows the commissioning window: fast advertising for the first
+// CONFIG_SOIL_BLE_ADV_FAST_MS after the window opens, slow advertising for the rest of it, and
+// off once it closes. A short press of the function button restarts the fast phase, or opens a
+// new window on an uncommissioned device. Time spent advertising is counted per mode, so the
+// advertising current can be derived from the configured intervals.
+//
+// With CONFIG_SOIL_BLE_TEARDOWN, a commissioned device disables the Bluetooth stack once no window
+// is open and the last BLE connection has closed. It is enabled again before the next BLE window
+// starts advertising: by the function button, or when the last fabric is removed.
+
+struct Stats
+{
+    uint32_t windows;        // fast phases started
+    uint32_t fastMs;         // time advertising at the fast interval
+    uint32_t slowMs;         // time advertising at the slow interval
+    uint32_t restarts;       // button-triggered restarts
+    uint32_t teardowns;      // times the Bluetooth stack was disabled
+    uint32_t heapFreeBleOn;  // Matter heap free bytes (CHIP, else kernel) just before the last teardown
+    uint32_t heapFreeBleOff; // and right after it
+};
+
 void ConfigureDeviceName();
+// Logs the ATT MTU each commissioner negotiates; link parameters are requested on connect.
+void InitLinkTuning();
+// Starts the fast phase if the commissioning window is already open at boot.
 void EnableAdvertising();
+// Safe from any thread; used by the function button.
+void RequestAdvertising();
 void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
 
+Stats GetStats();
+void LogStats();
+
 } // namespace ble_manager
 } // namespace connectivity
 
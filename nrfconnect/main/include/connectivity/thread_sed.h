@@ -0,0 +1,38 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <cstdint>
+
+namespace connectivity
+{
+namespace thread_sed
+{
+
+// Thread sleepy end device support for the nRF52840 build (prj_thread_sed.conf). The slow poll
+// period follows the sampling interval, capped at the 15 s short idle time limit; each report then
+// asks the ICD manager for active mode, which switches to fast polling until the acks are in.
+// Everything here is a no-op in Wi-Fi builds.
+
+struct Stats
+{
+    uint32_t attaches;
+    uint32_t detaches; // parent loss or stack restart after having been attached
+    uint32_t bursts;
+    bool attached;
+    bool sleepy;
+};
+
+// Brings up the OpenThread stack as an (S)SED; call after the CHIP stack is initialized.
+CHIP_ERROR Init();
+
+// A measurement is about to be reported; poll fast until the ICD active period ends.
+void BeginBurst();
+
+// Called from the kThreadStateChange event path to track attach state and the device role.
+void OnThreadStateChange();
+
+Stats GetStats();
+
+} // namespace thread_sed
+} // namespace connectivity
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <cstdint>
+
+namespace connectivity
+{
+namespace wifi_power_policy
+{
+
+// Picks the nRF70 station power-save mode from what the device is doing. Between measurements the
+// radio sleeps through beacons (listen-interval wakeup, i.e. DTIM skipping); a sample-and-report
+// burst, an open commissioning window or an OTA transfer switch power save off so traffic is not
+// held at the AP. Time spent in each state, and in the mode the driver accepted, is counted for
+// latency/battery trade-offs.
+
+enum class State : uint8_t
+{
+    Idle,
+    Burst,
+    Commissioning,
+    Ota,
+};
+
+enum class Mode : uint8_t
+{
+    PowerSave,
+    Active,
+};
+
+constexpr uint8_t kStateCount = 4;
+constexpr uint8_t kModeCount  = 2;
+
+// Longest the idle station sleeps between wakeups: CONFIG_SOIL_WIFI_PS_LISTEN_INTERVAL beacons of
+// the usual 100 TU (102.4 ms). Retransmitting sooner than this only reaches a sleeping radio.
+#if defined(CONFIG_SOIL_WIFI_POWER_POLICY)
+constexpr uint32_t kIdleWakeupPeriodMs = (CONFIG_SOIL_WIFI_PS_LISTEN_INTERVAL * 1024U + 9) / 10;
+#else
+constexpr uint32_t kIdleWakeupPeriodMs = 0;
+#endif
+
+struct Stats
+{
+    uint32_t stateMs[kStateCount];
+    uint32_t modeMs[kModeCount];
+    uint32_t transitions;
+    uint32_t applyFailures;
+    State state;
+    Mode mode;
+};
+
+void Init();
+
+// A measurement is about to be reported; stay active for the longest subscription min interval,
+// but at least CONFIG_SOIL_WIFI_PS_BURST_HOLD_MS.
+void BeginBurst();
+void SetCommissioning(bool active);
+void SetOta(bool active);
+
+// Follows commissioning window, OTA and Wi-Fi connectivity events.
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+Stats GetStats();
+void LogStats();
+
+// Compact little-endian snapshot served as a vendor diagnostics attribute.
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out);
+
+} // namespace wifi_power_policy
+} // namespace connectivity
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <lib/support/Span.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <cstdint>
+
+namespace connectivity
+{
+namespace wifi_reconnect
+{
+
+// Reconnects the station after a link loss. The backoff starts at
+// CONFIG_CHIP_WIFI_CONNECTION_RECOVERY_MINIMUM_INTERVAL and doubles per failed attempt up to the
+// maximum interval; a link that has been reliable recently is retried sooner, a weak one later, and
+// every delay is spread over half its length so a field of sensors does not retry in lockstep
+// after an AP outage. The last good BSSID, channel and security mode are kept in settings, so
+// reconnects, and the connect at boot, associate directly on that channel and only fall back to a
+// full scan if that fails. The SDK's own recovery retries are disabled
+// (CHIP_WIFI_CONNECTION_RECOVERY_MAX_RETRIES_NUMBER=0) so they do not race the directed attempt.
+
+enum class Path : uint8_t
+{
+    Directed,
+    Scan,
+};
+
+constexpr uint8_t kPathCount = 2;
+
+struct PathStats
+{
+    uint32_t attempts;
+    uint32_t reachedIp;
+    uint32_t lastToIpMs; // attempt start to IPv6 address assigned
+    uint32_t avgToIpMs;
+    uint32_t maxToIpMs;
+};
+
+struct Stats
+{
+    uint32_t losses;
+    uint32_t attempts;
+    uint32_t successes;
+    uint32_t failures;
+    uint32_t consecutiveFailures;
+    uint32_t lastBackoffMs;
+    uint32_t lastLatencyMs; // link loss to association
+    uint32_t minLatencyMs;
+    uint32_t maxLatencyMs;
+    uint32_t avgLatencyMs;
+    int8_t lastRssi;
+    PathStats paths[kPathCount];
+};
+
+// Restores the cached link and, with it and the stored credentials, starts the boot connect as a
+// directed association; without them, tracks the driver's connect to the stored network as a scan
+// attempt. Call after the Wi-Fi driver is initialized: the stored network is read from it.
+void Init();
+
+// Credential hooks for the network commissioning driver (wifi_scan_cache::Driver()). The nRF Wi-Fi
+// driver keeps its passphrase private, so the directed connect uses the copy staged through
+// AddOrUpdateNetwork, persisted under soil/wifi-cred when the configuration is committed and
+// dropped with the network or on factory reset (OnNetworkRemoved()). It sits in the same settings
+// partition as the driver's own copy.
+void OnNetworkStaged(chip::ByteSpan ssid, chip::ByteSpan credentials);
+void OnConfigurationCommitted();
+void OnConfigurationReverted();
+void OnNetworkRemoved();
+
+// Follows kWiFiConnectivityChange to start and stop the scheduler, and IPv6 address assignment
+// for the time-to-IP counters.
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+Stats GetStats();
+void LogStats();
+
+} // namespace wifi_reconnect
+} // namespace connectivity
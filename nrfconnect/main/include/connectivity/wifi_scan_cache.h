@@ -0,0 +1,40 @@
+#pragma once
+
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/NetworkCommissioning.h>
+
+#include <cstdint>
+
+namespace connectivity
+{
+namespace wifi_scan_cache
+{
+
+// Short-lived cache of ScanNetworks results in front of the nRF Wi-Fi driver. Commissioners often
+// scan several times in a row; a broadcast scan younger than CONFIG_SOIL_WIFI_SCAN_CACHE_TTL_MS is
+// answered from RAM without touching the radio, and directed scans are answered from it when the
+// SSID is in there. Results live in a fixed table of CONFIG_SOIL_WIFI_SCAN_CACHE_ENTRIES (strongest
+// kept), so the driver's heap-grown result list is released as soon as a radio scan completes. The
+// cache is dropped when the commissioning window closes or a network is connected.
+
+struct Stats
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t radioScans;
+    uint32_t dropped; // results that did not fit the table
+    uint8_t entries;
+};
+
+#if defined(CONFIG_CHIP_WIFI)
+// Driver to hand to the NetworkCommissioning cluster instead of NrfWiFiDriver.
+chip::DeviceLayer::NetworkCommissioning::WiFiDriver & Driver();
+#endif
+
+// Drops the cache when a commissioning window closes.
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+Stats GetStats();
+
+} // namespace wifi_scan_cache
+} // namespace connectivity
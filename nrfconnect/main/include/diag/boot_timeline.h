@@ -0,0 +1,51 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+#include <cstdint>
+
+namespace diag
+{
+namespace boot_timeline
+{
+
+// Boot-phase tracer for main(). Start()/Mark() stamp the beginning and end of a phase with the
+// kernel cycle counter; a phase without a Start() begins at the previous phase's end. Phases run
+// by the boot orchestrator may overlap. Complete() logs the timeline and persists it, so the
+// previous boot's timeline is still available after a reset. Both are served as a vendor
+// diagnostics attribute.
+
+enum class Phase : uint8_t
+{
+    PreMain = 0,      // kernel start until main() entry
+    SettingsInit,     // settings subsystem and NVS mount
+    ChipStackInit,    // InitChipStack
+    AppTaskStart,     // attestation, basic information, event handlers, AppTask
+    SettingsLoad,     // settings_load, BT keys and identity
+    WifiInit,         // Wi-Fi driver and network commissioning cluster, reconnect kick-off
+    ServerInit,       // storage delegates, static resources, Server::Init
+    Registrations,    // attribute overrides, event logging, MRP
+    AccessControl,    // management clusters, ACL, commissioning window
+    ClusterInit,      // time service, Wi-Fi commissioning, soil sensor
+    OnboardingLog,    // device config and onboarding codes on the UART
+    EventLoopStart,   // StartEventLoopTask
+    Advertising,      // BLE advertising enabled
+    kCount,
+};
+
+constexpr uint8_t kPhaseCount = static_cast<uint8_t>(Phase::kCount);
+
+void Begin();
+void Start(Phase phase);
+void Mark(Phase phase);
+void Complete();
+
+// Microseconds from kernel start to the start/end of `phase` on this boot; 0 if not reached.
+uint32_t GetPhaseStartUs(Phase phase);
+uint32_t GetPhaseEndUs(Phase phase);
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out);
+
+} // namespace boot_timeline
+} // namespace diag
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <app/ConcreteCommandPath.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <cstdint>
+
+namespace diag
+{
+namespace commissioning_timeline
+{
+
+// Commissioning phase timer. Each phase ends when the commissioner's request for it has been
+// handled, so the durations include the commissioner's think time and the BLE transfer of the
+// request and response; that transfer is what the BLE link tuning is meant to shorten. A new BLE
+// connection or PASE session restarts the timeline. Logged on completion or fail-safe expiry and
+// served as a vendor diagnostics attribute.
+
+enum class Phase : uint8_t
+{
+    Pase = 0,     // BLE connection (or PASE start on-network) until the PASE session is up
+    Csr,          // attestation and CSRRequest
+    AddNoc,       // trusted root and AddNOC
+    NetworkSetup, // network configuration, association, CASE and CommissioningComplete
+    kCount,
+};
+
+constexpr uint8_t kPhaseCount = static_cast<uint8_t>(Phase::kCount);
+
+void Init();
+
+// Follows the BLE connection, PASE session and commissioning complete events.
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+// Called once an invoke has been handled; marks the end of the CSR and AddNOC phases.
+void OnCommandHandled(const chip::app::ConcreteCommandPath & path);
+
+// Milliseconds spent in `phase` on the last commissioning attempt; 0 if not reached.
+uint32_t GetPhaseMs(Phase phase);
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out);
+
+} // namespace commissioning_timeline
+} // namespace diag
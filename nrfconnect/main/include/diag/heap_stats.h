@@ -0,0 +1,68 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <cstdint>
+
+namespace diag
+{
+namespace heap_stats
+{
+
+// Runtime statistics for the kernel heap (k_malloc, CONFIG_HEAP_MEM_POOL_SIZE) and the CHIP heap
+// (CONFIG_CHIP_MALLOC_SYS_HEAP_SIZE). Both report current and peak usage and the largest free
+// block; free bytes well above the largest block mean the heap is fragmented. The kernel heap's
+// largest block comes from a walk of its chunk list under the heap lock, and its allocations are
+// counted through a heap listener. The CHIP heap is private to the SDK: it has no counts, and its
+// largest block is only known with CONFIG_SOIL_HEAP_PROBE_CHIP, from trial allocations made when
+// the attribute is read.
+//
+// A sample is taken every CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S into a ring buffer, and whenever
+// commissioning completes or fails. With CONFIG_SOIL_HEAP_TAGS, k_malloc/k_calloc, and
+// malloc/calloc unless the CHIP heap overrides them, are wrapped at link time and counted per call
+// site. A largest free block of 0 means it was not measured. Dump() logs the lot, and Snapshot()
+// serves it as a vendor diagnostics attribute.
+
+struct HeapInfo
+{
+    uint32_t sizeBytes;
+    uint32_t usedBytes;
+    uint32_t peakBytes;
+    uint32_t largestFreeBytes;
+};
+
+struct Sample
+{
+    uint32_t uptimeS;
+    uint32_t kernelUsedBytes;
+    uint32_t kernelLargestFreeBytes;
+    uint32_t chipUsedBytes;
+    uint32_t chipLargestFreeBytes;
+};
+
+struct Stats
+{
+    HeapInfo kernel;
+    HeapInfo chip;
+    uint32_t kernelAllocs;
+    uint32_t kernelFrees;
+};
+
+// Registers the kernel heap listener and the vendor attribute and starts sampling. Call after
+// InitChipStack.
+void Init();
+
+// Samples and dumps when commissioning completes or the fail-safe expires.
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+// CHIP thread only.
+Stats GetStats();
+void TakeSample();
+void Dump();
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out);
+
+} // namespace heap_stats
+} // namespace diag
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+#include <cstdint>
+
+namespace diag
+{
+namespace nvs_telemetry
+{
+
+// Wear and compaction telemetry for the NVS backend behind settings_storage. NVS does not report
+// garbage collection, so it is inferred: every time the write sector advances, the next sector is
+// compacted and erased. Writes that go through BeginWrite()/EndWrite() time the GC they trigger;
+// advances caused by other writers (BT host, ConfigurationMgr) are counted but untimed.
+// Per-sector erase counts and the lifetime GC count persist across reboots. Without
+// CONFIG_SOIL_NVS_TELEMETRY the module is not built and Init() and the write probes are no-ops.
+
+struct Stats
+{
+    uint32_t freeBytes;
+    uint32_t minFreeBytes;
+    uint32_t gcCycles;        // lifetime
+    uint32_t untimedGcCycles; // this boot, caused by writers outside the probes
+    uint32_t lastGcUs;
+    uint32_t maxGcUs;
+    uint32_t totalGcUs; // this boot, timed cycles only
+    uint16_t sectorCount;
+    uint16_t activeSector;
+};
+
+struct WriteProbe
+{
+    uint32_t startCycles;
+    uint16_t sector;
+};
+
+#if defined(CONFIG_SOIL_NVS_TELEMETRY)
+
+void Init();
+
+WriteProbe BeginWrite();
+void EndWrite(const WriteProbe & probe);
+
+Stats GetStats();
+uint32_t GetEraseCount(uint16_t sector);
+void LogStats();
+
+// Compact little-endian snapshot served as a vendor diagnostics attribute.
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out);
+
+#else
+
+inline void Init() {}
+
+inline WriteProbe BeginWrite()
+{
+    return WriteProbe{};
+}
+
+inline void EndWrite(const WriteProbe &) {}
+
+#endif
+
+} // namespace nvs_telemetry
+} // namespace diag
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+#include <cstdint>
+
+namespace diag
+{
+namespace pool_stats
+{
+
+// Occupancy of the fixed pools that hold per-transaction CHIP objects (sized in
+// CHIPProjectConfig.h). Packet buffers and exchanges report their in-use count and high watermark
+// through chip::System::Stats; read and subscribe handlers are counted from the interaction model
+// engine and their watermark is kept here. A watermark that reaches the capacity is the sign, in
+// every build, that a pool ran out. Refused allocations are counted as they happen, from the
+// messages the SDK logs when a pool is empty. Those are Error and Progress messages, so the counts
+// stay 0 unless CHIP logging is compiled in at INF or above (never in prj_release.conf, which sets
+// CONFIG_LOG=n). Exchanges have no refusal message of their own and are never counted. Packet buffers report a capacity of 0 when they come from the
+// heap (CONFIG_SOIL_PACKET_BUFFER_POOL off). Sampled every CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S alongside the
+// heap statistics.
+
+enum class Pool : uint8_t
+{
+    PacketBuffers = 0,
+    Exchanges,
+    Reads,
+    Subscriptions,
+    kCount,
+};
+
+constexpr uint8_t kPoolCount = static_cast<uint8_t>(Pool::kCount);
+
+struct PoolInfo
+{
+    uint16_t capacity;
+    uint16_t inUse;
+    uint16_t highWatermark;
+    uint16_t refused; // allocations that failed because the pool was empty, see above
+};
+
+void Init();
+
+// CHIP thread only.
+PoolInfo GetPool(Pool pool);
+// Updates occupancy and warns about allocations refused, or a pool found full, since the previous
+// sample.
+void TakeSample();
+void LogStats();
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out);
+
+} // namespace pool_stats
+} // namespace diag
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <access/AccessControl.h>
+
+#include <cstdint>
+
+namespace matter
+{
+namespace acl_cache
+{
+
+// Decision cache in front of the ACL entry scan. Results are keyed by (fabric, auth mode,
+// subject and CATs, endpoint, cluster, request type, privilege) and dropped wholesale on any
+// ACL change, so a hit costs a short fixed-size lookup however many entries the fabrics hold.
+
+struct Stats
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t uncacheable; // PASE subjects and results other than allow/deny
+    uint32_t invalidations;
+};
+
+// Returns a delegate that caches decisions from `inner`; pass it to Server::Init as accessDelegate.
+chip::Access::AccessControl::Delegate * Wrap(chip::Access::AccessControl::Delegate * inner);
+
+void Invalidate();
+
+Stats GetStats();
+void LogStats();
+
+} // namespace acl_cache
+} // namespace matter
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace matter
+{
+namespace adaptive_mrp
+{
+
+// Retunes the locally advertised MRP idle/active retransmission intervals from measured ACK
+// round-trip times. Each peer keeps a smoothed RTT and RTT variance (RFC 6298 weights, Karn's rule
+// for retransmitted messages); the advertised intervals follow the slowest recently active peer,
+// clamped to fixed bounds and only changed when they move by more than a hysteresis margin.
+
+struct Stats
+{
+    uint32_t initialSends;
+    uint32_t retransmissions;
+    uint32_t acks;
+    uint32_t failures;
+    uint32_t rttSamples;
+    uint32_t retunes;
+    uint32_t activeIntervalMs;
+    uint32_t idleIntervalMs;
+};
+
+// Registers the MRP analytics hook; call after Server::Init(), once the starting config is applied.
+void Init(uint32_t idleIntervalMs, uint32_t activeIntervalMs);
+
+Stats GetStats();
+void LogStats();
+
+} // namespace adaptive_mrp
+} // namespace matter
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <app/AttributeValueEncoder.h>
+#include <app/ConcreteAttributePath.h>
+#include <app/data-model/Encode.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <zephyr/sys/util.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace matter
+{
+namespace report_cache
+{
+
+// Encoded-once attribute values shared by every subscription that reports them.
+// A value is TLV-encoded when it changes and stamped with the owning cluster's
+// data version; report generation copies the cached element for as long as the
+// cluster version still matches.
+
+constexpr size_t kMaxEntries     = 4;
+constexpr size_t kMaxEncodedSize = 16;
+
+using DataVersionGetter = chip::DataVersion (*)();
+
+struct Stats
+{
+    uint32_t changes;          // values committed to the cache
+    uint32_t encodes;          // TLV encodes performed on change
+    uint32_t reuses;           // report payloads copied from the cache
+    uint32_t fallbacks;        // reads served by the regular encode path
+    uint16_t lastChangeFanout; // reports served by the previous change
+    uint16_t maxChangeFanout;
+};
+
+CHIP_ERROR RegisterAttribute(const chip::app::ConcreteAttributePath & path, DataVersionGetter getDataVersion);
+
+CHIP_ERROR StoreEncoded(const chip::app::ConcreteAttributePath & path, chip::ByteSpan encoded);
+
+template <typename T>
+CHIP_ERROR Store(const chip::app::ConcreteAttributePath & path, const T & value)
+{
+    if (!IS_ENABLED(CONFIG_SOIL_REPORT_ENCODE_CACHE))
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    uint8_t buffer[kMaxEncodedSize];
+    chip::TLV::TLVWriter writer;
+    writer.Init(buffer);
+    ReturnErrorOnFailure(chip::app::DataModel::Encode(writer, chip::TLV::AnonymousTag(), value));
+    ReturnErrorOnFailure(writer.Finalize());
+    return StoreEncoded(path, chip::ByteSpan(buffer, writer.GetLengthWritten()));
+}
+
+// Returns true when `path` was answered from the cache; `err` then carries the encoder result.
+// Returns false when the caller must fall back to the regular read path.
+bool TryEncode(const chip::app::ConcreteAttributePath & path, chip::app::AttributeValueEncoder & encoder, CHIP_ERROR & err);
+
+Stats GetStats();
+void LogStats();
+
+} // namespace report_cache
+} // namespace matter
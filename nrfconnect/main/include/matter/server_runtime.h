@@ -8,6 +8,12 @@ namespace server_runtime
 void InitEventLogging();
 void ConfigureDynamicMrp();
 void InitWifiCommissioningCluster();
+void InitThreadCommissioningCluster();
+
+// Server::Init() schedules resumption of persisted subscriptions, usually before Wi-Fi has an
+// address. This retries once the first IPv6 address is assigned so subscribers get data again
+// within seconds instead of waiting for their subscription to time out.
+void ResumeSubscriptionsWhenOnline();
 
 } // namespace server_runtime
 } // namespace matter
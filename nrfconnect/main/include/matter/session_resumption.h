@@ -0,0 +1,42 @@
+#pragma once
+
+#include <lib/core/DataModelTypes.h>
+#include <protocols/secure_channel/SessionResumptionStorage.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace matter
+{
+namespace session_resumption
+{
+
+// Instrumented pass-through in front of the server's session resumption storage. Counts, per
+// fabric, how many CASE handshakes completed by resuming a stored session and how many needed the
+// full Sigma exchange, so it is visible when controllers stop resuming. A handshake is counted when
+// it completes and its record is saved; it counts as resumed only if it kept the shared secret of
+// the record looked up for it, so a resumption attempt that fell back to full CASE counts as full.
+
+struct FabricStats
+{
+    chip::FabricIndex fabricIndex;
+    uint32_t resumed;
+    uint32_t fullCase;
+};
+
+struct Stats
+{
+    uint32_t unknownIds; // Sigma1 resumption IDs with no stored record (evicted or wiped)
+    uint32_t saves;
+    uint32_t deletes;
+};
+
+// Returns storage that records statistics for `inner`; pass it to Server::Init as sessionResumptionStorage.
+chip::SessionResumptionStorage * Wrap(chip::SessionResumptionStorage * inner);
+
+Stats GetStats();
+size_t GetFabricStats(FabricStats * out, size_t maxCount);
+void LogStats();
+
+} // namespace session_resumption
+} // namespace matter
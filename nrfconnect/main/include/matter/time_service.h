@@ -0,0 +1,36 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <cstdint>
+
+namespace matter
+{
+namespace time_service
+{
+
+// Wall-clock service anchored on SetUTCTime. Each sync records a (monotonic, UTC) anchor;
+// successive syncs estimate the RTC drift so any monotonic timestamp can be converted to
+// UTC with integer math between syncs. UTC values are Matter (chip) epoch microseconds.
+// The anchor and drift are persisted (throttled) and restored at boot as a lower-confidence
+// estimate until the next sync.
+
+struct Anchor
+{
+    uint64_t monotonicUs;
+    uint64_t utcUs;
+};
+
+void Init();
+void SetUtcTime(uint64_t chipEpochUs);
+
+bool HasTime();
+bool IsRestored();
+CHIP_ERROR GetUtcNow(uint64_t & chipEpochUs);
+CHIP_ERROR MonotonicToUtc(uint64_t monotonicUs, uint64_t & chipEpochUs);
+
+Anchor GetAnchor();
+int32_t GetDriftPpb();
+
+} // namespace time_service
+} // namespace matter
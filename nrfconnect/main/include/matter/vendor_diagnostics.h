@@ -0,0 +1,44 @@
+#pragma once
+
+#include <app/AttributeValueEncoder.h>
+#include <app/ConcreteAttributePath.h>
+#include <app/data-model-provider/MetadataTypes.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/ReadOnlyBuffer.h>
+#include <lib/support/Span.h>
+
+#include <cstddef>
+
+namespace matter
+{
+namespace vendor_diagnostics
+{
+
+// Manufacturer-specific (VID 0xFFF1) attributes on the root endpoint's General Diagnostics cluster.
+// Each one is an octet string holding a compact little-endian snapshot produced on read, so fleet
+// tooling can pull device telemetry over the regular read path.
+
+constexpr chip::AttributeId kNvsTelemetry          = 0xFFF10000;
+constexpr chip::AttributeId kBootTimeline          = 0xFFF10001;
+constexpr chip::AttributeId kWifiPowerPolicy       = 0xFFF10002;
+constexpr chip::AttributeId kCommissioningTimeline = 0xFFF10003;
+constexpr chip::AttributeId kHeapStats             = 0xFFF10004;
+constexpr chip::AttributeId kPoolStats             = 0xFFF10005;
+
+constexpr size_t kMaxAttributes = 6;
+constexpr size_t kMaxValueSize  = 256;
+
+// Fills `out` with the snapshot and shrinks it to the encoded length.
+using Snapshot = CHIP_ERROR (*)(chip::MutableByteSpan & out);
+
+CHIP_ERROR Register(chip::AttributeId attributeId, Snapshot snapshot);
+
+CHIP_ERROR AppendAttributes(const chip::app::ConcreteClusterPath & path,
+                            chip::ReadOnlyBufferBuilder<chip::app::DataModel::AttributeEntry> & builder);
+
+// Returns true when `path` is a registered vendor attribute; `err` then carries the encoder result.
+bool TryRead(const chip::app::ConcreteAttributePath & path, chip::app::AttributeValueEncoder & encoder, CHIP_ERROR & err);
+
+} // namespace vendor_diagnostics
+} // namespace matter
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/ConcreteEventPath.h>
+#include <lib/core/DataModelTypes.h>
+
+#include <cstdint>
+
+namespace sensors
+{
+namespace soil_threshold_events
+{
+
+// Manufacturer-specific (VID 0xFFF1) events on the soil endpoint's Soil Measurement cluster, emitted
+// when the moisture crosses CONFIG_SOIL_DRY_THRESHOLD_PERCENT or CONFIG_SOIL_WET_THRESHOLD_PERCENT.
+constexpr chip::ClusterId kClusterId         = chip::app::Clusters::SoilMeasurement::Id;
+constexpr chip::EventId kDryThresholdCrossed = 0xFFF10000;
+constexpr chip::EventId kWetThresholdCrossed = 0xFFF10001;
+
+void Init();
+void OnMeasurement(chip::EndpointId endpoint, uint8_t percent);
+
+bool IsThresholdEvent(const chip::app::ConcreteEventPath & path);
+
+} // namespace soil_threshold_events
+} // namespace sensors
@@ -20,6 +20,8 @@
 
 #include "AppConfig.h"
 #include "app/AppEvent.h"
+#include "connectivity/ble_manager.h"
+#include "connectivity/thread_sed.h"
 #include "LEDUtil.h"
 #include "matter/IdentifyHandler.h"
 
@@ -219,6 +221,8 @@ void AppTask::FunctionHandler(const AppEvent & event)
             CancelTimer();
             Instance().mFunction = FunctionEvent::NoneSelected;
             LOG_INF("Factory Reset trigger canceled before timeout");
+            // A short press (re)starts commissioning advertising.
+            connectivity::ble_manager::RequestAdvertising();
         }
         else if (Instance().mFunctionTimerActive && Instance().mFunction == FunctionEvent::FactoryReset)
         {
@@ -336,6 +340,7 @@ void AppTask::ChipEventHandler(const ChipDeviceEvent * event, intptr_t)
     case DeviceEventType::kThreadStateChange:
         sIsNetworkProvisioned = ConnectivityMgr().IsThreadProvisioned();
         sIsNetworkEnabled     = ConnectivityMgr().IsThreadEnabled();
+        connectivity::thread_sed::OnThreadStateChange();
         UpdateStatusLED();
         break;
     default:
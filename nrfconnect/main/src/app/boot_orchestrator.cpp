@@ -0,0 +1,80 @@
+#include "app/boot_orchestrator.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace app
+{
+namespace boot_orchestrator
+{
+
+namespace
+{
+
+bool RunStep(const Step & step)
+{
+    diag::boot_timeline::Start(step.phase);
+    const bool ok = step.run();
+    diag::boot_timeline::Mark(step.phase);
+
+    if (!ok)
+    {
+        LOG_ERR("Boot step '%s' failed", step.name);
+    }
+    return ok;
+}
+
+// Index of the first step not yet run whose dependencies are done, or count if there is none.
+size_t NextReadyStep(const Step * steps, size_t count, uint32_t done)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!(done & (1u << i)) && !(steps[i].dependsOn & ~done))
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+bool Run(const Step * steps, size_t count)
+{
+    if (count > kMaxSteps)
+    {
+        LOG_ERR("Boot graph has %u steps, max %u", static_cast<unsigned>(count), static_cast<unsigned>(kMaxSteps));
+        return false;
+    }
+
+    const uint32_t all = (1u << count) - 1;
+    uint32_t done      = 0;
+    bool failed        = false;
+
+    const uint32_t startCycles = k_cycle_get_32();
+
+    while (done != all)
+    {
+        const size_t next = NextReadyStep(steps, count, done);
+        if (next == count)
+        {
+            LOG_ERR("Boot graph stalled: done 0x%08x of 0x%08x", done, all);
+            failed = true;
+            break;
+        }
+        if (!RunStep(steps[next]))
+        {
+            failed = true;
+            break;
+        }
+        done |= 1u << next;
+    }
+
+    LOG_INF("Boot steps %s in %u ms", failed ? "aborted" : "completed", k_cyc_to_ms_floor32(k_cycle_get_32() - startCycles));
+    return !failed;
+}
+
+} // namespace boot_orchestrator
+} // namespace app
@@ -1,11 +1,15 @@
 #include "app/factory_reset.h"
 
+#include "cfg/settings_writeback.h"
+#include "connectivity/wifi_reconnect.h"
 #include "matter/access_manager.h"
 
 #include <lib/core/CHIPError.h>
 #include <lib/core/ErrorStr.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <platform/KeyValueStoreManager.h>
 #include <zephyr/kernel.h>
+#include <zephyr/logging/log_ctrl.h>
 
 LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
 
@@ -19,6 +23,34 @@ namespace
 
 bool sFactoryResetScheduled = false;
 
+// Erases the whole settings partition (fabrics, ACLs, keys, sessions, groups, Wi-Fi credentials,
+// BT identity and the app's own records) instead of tearing Matter state down entry by entry.
+// The SDK's KVS reset does it through nvs_clear() and a remount rather than by reaching into the
+// nvs_fs state. The time taken is logged; it grows with the partition size rather than with the
+// number of fabrics or ACL entries. In-RAM state is invalidated by the reboot that must follow.
+// Returns false when the slow path has to run instead.
+bool FastWipe()
+{
+    if (!IS_ENABLED(CONFIG_SOIL_FAST_FACTORY_RESET))
+    {
+        return false;
+    }
+
+    // Nothing pending may be written back over the cleared partition.
+    cfg::settings_writeback::Discard();
+
+    const uint32_t startMs = k_uptime_get_32();
+    CHIP_ERROR err         = chip::DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().DoFactoryReset();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(AppServer, "Fast wipe failed: %s", chip::ErrorStr(err));
+        return false;
+    }
+
+    LOG_INF("Fast wipe: settings partition erased in %u ms", k_uptime_get_32() - startMs);
+    return true;
+}
+
 void DoFactoryResetLikeNordic()
 {
     if (sFactoryResetScheduled)
@@ -28,11 +60,22 @@ void DoFactoryResetLikeNordic()
 
     sFactoryResetScheduled = true;
 
+    if (FastWipe())
+    {
+        // Nothing left to settle; just get the log out before the reset.
+        LOG_PANIC();
+        NVIC_SystemReset();
+    }
+
     CHIP_ERROR wipeErr = matter::access_manager::DoFullMatterWipe();
     if (wipeErr != CHIP_NO_ERROR)
     {
         ChipLogError(AppServer, "DoFullMatterWipe failed: %s", chip::ErrorStr(wipeErr));
     }
+    // Deferred records belong to the state just wiped; they must not be written back.
+    cfg::settings_writeback::Discard();
+    // The KVS reset above does not reach the reconnect module's own copy of the passphrase.
+    connectivity::wifi_reconnect::OnNetworkRemoved();
 
     constexpr uint32_t kResetDelayMs = 150;
     k_msleep(kResetDelayMs);
@@ -0,0 +1,91 @@
+#include "app/reboot.h"
+
+#include "cfg/settings_writeback.h"
+
+#include <zephyr/fatal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/sys/reboot.h>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace app
+{
+namespace reboot
+{
+
+namespace
+{
+
+#if defined(CONFIG_SOIL_FATAL_ERROR_REBOOT)
+// Upper bound on the flush after a fatal error; a wedged flash or a settings lock held by the dead
+// thread must not keep the device from rebooting.
+constexpr uint32_t kFatalFlushTimeoutMs = 1000;
+
+void FatalReboot(k_timer *)
+{
+    sys_reboot(SYS_REBOOT_COLD);
+}
+
+K_TIMER_DEFINE(sFatalTimeout, FatalReboot, nullptr);
+
+void FlushAndReboot(k_work *)
+{
+    cfg::settings_writeback::FlushAfterFault();
+    LOG_PANIC();
+    sys_reboot(SYS_REBOOT_COLD);
+}
+
+K_WORK_DEFINE(sFatalFlushWork, FlushAndReboot);
+
+// Whether the system can keep running with the faulting thread aborted long enough to flush.
+bool CanFlushAfter(unsigned int reason, const struct arch_esf * esf)
+{
+    if (reason == K_ERR_KERNEL_PANIC || k_current_get() == &k_sys_work_q.thread)
+    {
+        return false;
+    }
+#if defined(CONFIG_CPU_CORTEX_M)
+    // A non-zero exception number in the stacked xPSR means the fault hit an ISR.
+    return esf != nullptr && (esf->basic.xpsr & IPSR_ISR_Msk) == 0;
+#else
+    ARG_UNUSED(esf);
+    return false;
+#endif
+}
+#endif
+
+} // namespace
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+    if (event->Type == chip::DeviceLayer::DeviceEventType::kOtaStateChanged &&
+        event->OtaStateChanged.newState == chip::DeviceLayer::kOtaApplyInProgress)
+    {
+        // The SDK reboots into the new image shortly after this event.
+        LOG_INF("OTA apply: flushing pending settings");
+        cfg::settings_writeback::FlushNow();
+    }
+}
+
+} // namespace reboot
+} // namespace app
+
+#if defined(CONFIG_SOIL_FATAL_ERROR_REBOOT)
+extern "C" void k_sys_fatal_error_handler(unsigned int reason, const struct arch_esf * esf)
+{
+    using namespace app::reboot;
+
+    LOG_ERR("Fatal error %u, rebooting", reason);
+    if (!CanFlushAfter(reason, esf))
+    {
+        LOG_PANIC();
+        sys_reboot(SYS_REBOOT_COLD);
+    }
+
+    // Returning aborts the faulting thread; the rest of the system stays up for the flush.
+    k_timer_start(&sFatalTimeout, K_MSEC(kFatalFlushTimeoutMs), K_NO_WAIT);
+    (void) k_work_submit(&sFatalFlushWork);
+}
+#endif
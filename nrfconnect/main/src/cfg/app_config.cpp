@@ -1,5 +1,6 @@
 #include "cfg/app_config.h"
 
+#include "cfg/config_cache.h"
 #include "matter/SoilDeviceInfoProvider.h"
 
 #include <app/clusters/basic-information/BasicInformationCluster.h>
@@ -47,13 +48,12 @@ void ConfigureBasicInformation()
                   "CONFIG_CHIP_DEVICE_COUNTRY_CODE exceeds the maximum Basic Information country code length");
     char countryCode[chip::DeviceLayer::ConfigurationManager::kMaxLocationLength + 1] = {};
     size_t codeLen                                                               = 0;
-    CHIP_ERROR locationErr = chip::DeviceLayer::ConfigurationMgr().GetCountryCode(countryCode, sizeof(countryCode), codeLen);
+    CHIP_ERROR locationErr = cfg::config_cache::GetCountryCode(countryCode, sizeof(countryCode), codeLen);
 
     if ((locationErr != CHIP_NO_ERROR) || (codeLen != sizeof(kDefaultCountryCode) - 1))
     {
         // Only populate a default when nothing has been provisioned yet.
-        if (chip::DeviceLayer::ConfigurationMgr().StoreCountryCode(kDefaultCountryCode, sizeof(kDefaultCountryCode) - 1) !=
-            CHIP_NO_ERROR)
+        if (cfg::config_cache::StoreCountryCode(kDefaultCountryCode, sizeof(kDefaultCountryCode) - 1) != CHIP_NO_ERROR)
         {
             LOG_WRN("Failed to persist default country code");
         }
@@ -63,11 +63,14 @@ void ConfigureBasicInformation()
     uint8_t month;
     uint8_t day;
     constexpr char kManufacturingDate[] = "2024-01-15";
-    CHIP_ERROR mfgErr = chip::DeviceLayer::SoilDeviceInstanceInfoProvider::Instance().GetManufacturingDate(year, month, day);
+    CHIP_ERROR mfgErr = cfg::config_cache::GetManufacturingDate(year, month, day);
     if ((mfgErr != CHIP_NO_ERROR) || (year != 2024) || (month != 1) || (day != 15))
     {
-        (void) chip::DeviceLayer::ConfigurationMgr().StoreManufacturingDate(kManufacturingDate, strlen(kManufacturingDate));
+        (void) cfg::config_cache::StoreManufacturingDate(kManufacturingDate, strlen(kManufacturingDate));
     }
+
+    // Load the rest up front so the first Basic Information read does not touch flash either.
+    cfg::config_cache::Populate();
 }
 
 } // namespace app_config
@@ -0,0 +1,243 @@
+#include "cfg/config_cache.h"
+
+#include "matter/SoilDeviceInfoProvider.h"
+
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/ConfigurationManager.h>
+
+#include <cstring>
+
+namespace cfg
+{
+namespace config_cache
+{
+
+namespace
+{
+
+using chip::DeviceLayer::ConfigurationManager;
+using chip::DeviceLayer::ConfigurationMgr;
+using chip::DeviceLayer::DeviceInstanceInfoProviderImpl;
+using chip::DeviceLayer::SoilDeviceInstanceInfoProvider;
+
+// Accessed from main() during boot and from the CHIP thread afterwards, never concurrently.
+template <typename T>
+struct Slot
+{
+    T value;
+    CHIP_ERROR status = CHIP_NO_ERROR;
+    bool valid        = false;
+};
+
+template <size_t N>
+struct Text
+{
+    char text[N + 1];
+};
+
+struct CountryCode
+{
+    char code[ConfigurationManager::kMaxLocationLength + 1];
+    size_t len;
+};
+
+struct Date
+{
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+};
+
+Slot<Text<ConfigurationManager::kMaxUniqueIDLength>> sUniqueId;
+Slot<Text<ConfigurationManager::kMaxSerialNumberLength>> sSerialNumber;
+Slot<uint32_t> sConfigurationVersion;
+Slot<CountryCode> sCountryCode;
+Slot<Date> sManufacturingDate;
+Slot<uint16_t> sHardwareVersion;
+Stats sStats = {};
+
+template <typename T, typename Loader>
+const Slot<T> & Fetch(Slot<T> & slot, Loader load)
+{
+    if (slot.valid)
+    {
+        sStats.hits++;
+        return slot;
+    }
+
+    slot.value  = T{};
+    slot.status = load(slot.value);
+    slot.valid  = true;
+    sStats.loads++;
+    return slot;
+}
+
+template <typename T>
+void Invalidate(Slot<T> & slot)
+{
+    slot.valid = false;
+    sStats.invalidations++;
+}
+
+CHIP_ERROR CopyText(const char * text, char * buf, size_t bufSize)
+{
+    VerifyOrReturnError(buf != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(strlen(text) + 1 <= bufSize, CHIP_ERROR_BUFFER_TOO_SMALL);
+    chip::Platform::CopyString(buf, bufSize, text);
+    return CHIP_NO_ERROR;
+}
+
+const Slot<Text<ConfigurationManager::kMaxUniqueIDLength>> & FetchUniqueId()
+{
+    return Fetch(sUniqueId, [](Text<ConfigurationManager::kMaxUniqueIDLength> & value) {
+        return ConfigurationMgr().GetUniqueId(value.text, sizeof(value.text));
+    });
+}
+
+const Slot<Text<ConfigurationManager::kMaxSerialNumberLength>> & FetchSerialNumber()
+{
+    // Qualified calls reach the storage-backed implementation rather than our cached overrides.
+    return Fetch(sSerialNumber, [](Text<ConfigurationManager::kMaxSerialNumberLength> & value) {
+        return SoilDeviceInstanceInfoProvider::Instance().DeviceInstanceInfoProviderImpl::GetSerialNumber(value.text,
+                                                                                                           sizeof(value.text));
+    });
+}
+
+const Slot<uint32_t> & FetchConfigurationVersion()
+{
+    return Fetch(sConfigurationVersion, [](uint32_t & value) { return ConfigurationMgr().GetConfigurationVersion(value); });
+}
+
+const Slot<CountryCode> & FetchCountryCode()
+{
+    return Fetch(sCountryCode, [](CountryCode & value) {
+        return ConfigurationMgr().GetCountryCode(value.code, sizeof(value.code), value.len);
+    });
+}
+
+const Slot<Date> & FetchManufacturingDate()
+{
+    return Fetch(sManufacturingDate, [](Date & value) {
+        return SoilDeviceInstanceInfoProvider::Instance().DeviceInstanceInfoProviderImpl::GetManufacturingDate(
+            value.year, value.month, value.day);
+    });
+}
+
+const Slot<uint16_t> & FetchHardwareVersion()
+{
+    return Fetch(sHardwareVersion, [](uint16_t & value) {
+        return SoilDeviceInstanceInfoProvider::Instance().DeviceInstanceInfoProviderImpl::GetHardwareVersion(value);
+    });
+}
+
+} // namespace
+
+void Populate()
+{
+    (void) FetchUniqueId();
+    (void) FetchSerialNumber();
+    (void) FetchConfigurationVersion();
+    (void) FetchCountryCode();
+    (void) FetchManufacturingDate();
+    (void) FetchHardwareVersion();
+}
+
+CHIP_ERROR GetUniqueId(char * buf, size_t bufSize)
+{
+    const auto & slot = FetchUniqueId();
+    ReturnErrorOnFailure(slot.status);
+    return CopyText(slot.value.text, buf, bufSize);
+}
+
+CHIP_ERROR GetConfigurationVersion(uint32_t & configurationVersion)
+{
+    const auto & slot = FetchConfigurationVersion();
+    ReturnErrorOnFailure(slot.status);
+    configurationVersion = slot.value;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR GetCountryCode(char * buf, size_t bufSize, size_t & codeLen)
+{
+    const auto & slot = FetchCountryCode();
+    ReturnErrorOnFailure(slot.status);
+    VerifyOrReturnError(buf != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(slot.value.len <= bufSize, CHIP_ERROR_BUFFER_TOO_SMALL);
+    memcpy(buf, slot.value.code, slot.value.len);
+    if (slot.value.len < bufSize)
+    {
+        buf[slot.value.len] = '\0';
+    }
+    codeLen = slot.value.len;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR GetManufacturingDate(uint16_t & year, uint8_t & month, uint8_t & day)
+{
+    const auto & slot = FetchManufacturingDate();
+    ReturnErrorOnFailure(slot.status);
+    year  = slot.value.year;
+    month = slot.value.month;
+    day   = slot.value.day;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR GetSerialNumber(char * buf, size_t bufSize)
+{
+    const auto & slot = FetchSerialNumber();
+    ReturnErrorOnFailure(slot.status);
+    return CopyText(slot.value.text, buf, bufSize);
+}
+
+CHIP_ERROR GetHardwareVersion(uint16_t & hardwareVersion)
+{
+    const auto & slot = FetchHardwareVersion();
+    ReturnErrorOnFailure(slot.status);
+    hardwareVersion = slot.value;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StoreCountryCode(const char * code, size_t codeLen)
+{
+    VerifyOrReturnError(code != nullptr && codeLen <= ConfigurationManager::kMaxLocationLength, CHIP_ERROR_INVALID_ARGUMENT);
+    Invalidate(sCountryCode);
+    ReturnErrorOnFailure(ConfigurationMgr().StoreCountryCode(code, codeLen));
+
+    memcpy(sCountryCode.value.code, code, codeLen);
+    sCountryCode.value.code[codeLen] = '\0';
+    sCountryCode.value.len           = codeLen;
+    sCountryCode.status              = CHIP_NO_ERROR;
+    sCountryCode.valid               = true;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StoreManufacturingDate(const char * date, size_t dateLen)
+{
+    // The stored string is parsed by the provider, so reload rather than parse it twice.
+    Invalidate(sManufacturingDate);
+    return ConfigurationMgr().StoreManufacturingDate(date, dateLen);
+}
+
+void InvalidateCountryCode()
+{
+    Invalidate(sCountryCode);
+}
+
+void InvalidateAll()
+{
+    Invalidate(sUniqueId);
+    Invalidate(sSerialNumber);
+    Invalidate(sConfigurationVersion);
+    Invalidate(sCountryCode);
+    Invalidate(sManufacturingDate);
+    Invalidate(sHardwareVersion);
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+} // namespace config_cache
+} // namespace cfg
@@ -0,0 +1,466 @@
+#include "cfg/settings_writeback.h"
+
+#include "diag/nvs_telemetry.h"
+
+#include <lib/core/ErrorStr.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#if defined(CONFIG_SETTINGS_NVS)
+#include <zephyr/fs/nvs.h>
+#endif
+
+#include <cstring>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace cfg
+{
+namespace settings_writeback
+{
+
+namespace
+{
+
+constexpr size_t kSlotCount       = CONFIG_SOIL_SETTINGS_WRITEBACK_SLOTS;
+constexpr size_t kMaxValueSize    = CONFIG_SOIL_SETTINGS_WRITEBACK_MAX_VALUE_SIZE;
+constexpr size_t kMaxKeyLength    = chip::PersistentStorageDelegate::kKeyLengthMax;
+constexpr size_t kMaxTrackedKeys  = 16;
+constexpr uint32_t kLogEveryFlush = 16;
+constexpr char kOtherKeys[]       = "(other)";
+
+enum class Target : uint8_t
+{
+    Settings, // raw Zephyr settings key, flushed with settings_save_one()
+    Matter,   // Matter KVS key, flushed through the server's storage delegate
+};
+
+struct Slot
+{
+    bool used;
+    Target target;
+    uint16_t len;
+    char key[kMaxKeyLength + 1];
+    uint8_t data[kMaxValueSize];
+};
+
+Slot sSlots[kSlotCount];
+KeyStats sKeyStats[kMaxTrackedKeys];
+size_t sKeyStatsCount = 0;
+Stats sStats          = {};
+
+chip::PersistentStorageDelegate * sMatterStorage = nullptr;
+
+K_MUTEX_DEFINE(sLock);
+k_work_delayable sFlushWork;
+bool sInitialized = false;
+
+// Matter keys that churn at runtime and are safe to lose on power failure: each one is
+// recreated by the next CASE, subscription or time sync. Counters, fabric and ACL data,
+// operational keys and group keys are always written through.
+bool IsDeferrableMatterKey(const char * key)
+{
+    if (strcmp(key, "g/lkgt") == 0 || strcmp(key, "g/sri") == 0)
+    {
+        return true;
+    }
+    if (strncmp(key, "g/s/", 4) == 0 || strncmp(key, "g/su/", 5) == 0)
+    {
+        return true;
+    }
+    // f/<fabric index>/s/<peer node id>: per-peer session resumption link.
+    if (strncmp(key, "f/", 2) == 0)
+    {
+        const char * sep = strchr(key + 2, '/');
+        return sep != nullptr && strncmp(sep, "/s/", 3) == 0;
+    }
+    return false;
+}
+
+KeyStats & StatsFor(const char * key)
+{
+    for (size_t i = 0; i < sKeyStatsCount; i++)
+    {
+        if (strcmp(sKeyStats[i].key, key) == 0)
+        {
+            return sKeyStats[i];
+        }
+    }
+
+    // Keep the last entry as a catch-all once the table is full.
+    if (sKeyStatsCount < kMaxTrackedKeys - 1)
+    {
+        KeyStats & entry = sKeyStats[sKeyStatsCount++];
+        strncpy(entry.key, key, sizeof(entry.key) - 1);
+        return entry;
+    }
+    KeyStats & other = sKeyStats[kMaxTrackedKeys - 1];
+    if (other.key[0] == '\0')
+    {
+        strncpy(other.key, kOtherKeys, sizeof(other.key) - 1);
+        sKeyStatsCount = kMaxTrackedKeys;
+    }
+    return other;
+}
+
+Slot * FindSlot(Target target, const char * key)
+{
+    for (Slot & slot : sSlots)
+    {
+        if (slot.used && slot.target == target && strcmp(slot.key, key) == 0)
+        {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+Slot * AllocateSlot()
+{
+    for (Slot & slot : sSlots)
+    {
+        if (!slot.used)
+        {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void RecordRequest(const char * key, size_t len)
+{
+    k_mutex_lock(&sLock, K_FOREVER);
+    KeyStats & stats = StatsFor(key);
+    stats.requestedWrites++;
+    stats.requestedBytes += len;
+    sStats.requestedWrites++;
+    k_mutex_unlock(&sLock);
+}
+
+void RecordFlash(const char * key, size_t len)
+{
+    k_mutex_lock(&sLock, K_FOREVER);
+    KeyStats & stats = StatsFor(key);
+    stats.flashWrites++;
+    stats.flashBytes += len;
+    sStats.flashWrites++;
+    sStats.flashBytes += len;
+    k_mutex_unlock(&sLock);
+}
+
+CHIP_ERROR WriteMatter(const char * key, const void * data, size_t len)
+{
+    VerifyOrReturnError(sMatterStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    const diag::nvs_telemetry::WriteProbe probe = diag::nvs_telemetry::BeginWrite();
+    CHIP_ERROR err                              = sMatterStorage->SyncSetKeyValue(key, data, static_cast<uint16_t>(len));
+    diag::nvs_telemetry::EndWrite(probe);
+    ReturnErrorOnFailure(err);
+    RecordFlash(key, len);
+    return CHIP_NO_ERROR;
+}
+
+int WriteSettings(const char * key, const void * data, size_t len)
+{
+    const diag::nvs_telemetry::WriteProbe probe = diag::nvs_telemetry::BeginWrite();
+    int rc                                      = settings_save_one(key, data, len);
+    diag::nvs_telemetry::EndWrite(probe);
+    if (rc == 0)
+    {
+        RecordFlash(key, len);
+    }
+    return rc;
+}
+
+void FlushPending()
+{
+    char key[kMaxKeyLength + 1];
+    uint8_t data[kMaxValueSize];
+    size_t flushed = 0;
+
+    // Copy each slot out under the lock and write it without the lock held, so writers are
+    // never blocked on flash. A key re-written meanwhile lands in a fresh slot and is flushed
+    // after this copy, preserving order.
+    for (size_t i = 0; i < kSlotCount; i++)
+    {
+        k_mutex_lock(&sLock, K_FOREVER);
+        Slot & slot = sSlots[i];
+        if (!slot.used)
+        {
+            k_mutex_unlock(&sLock);
+            continue;
+        }
+        const Target target = slot.target;
+        const size_t len    = slot.len;
+        memcpy(key, slot.key, sizeof(key));
+        memcpy(data, slot.data, len);
+        slot.used = false;
+        k_mutex_unlock(&sLock);
+
+        if (target == Target::Matter)
+        {
+            CHIP_ERROR err = WriteMatter(key, data, len);
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(DeviceLayer, "Deferred write of %s dropped: %s", key, chip::ErrorStr(err));
+            }
+        }
+        else if (WriteSettings(key, data, len) != 0)
+        {
+            LOG_WRN("Deferred settings write for %s dropped", key);
+        }
+        flushed++;
+    }
+
+    if (flushed == 0)
+    {
+        return;
+    }
+
+    k_mutex_lock(&sLock, K_FOREVER);
+    const uint32_t flushes = ++sStats.flushes;
+    k_mutex_unlock(&sLock);
+
+    if ((flushes % kLogEveryFlush) == 0)
+    {
+        LogStats();
+    }
+}
+
+void FlushWorkHandler(k_work *)
+{
+    // The Matter storage delegate is only safe on the CHIP thread; raw settings writes go the same way
+    // so a flush is always one ordered batch.
+    (void) chip::DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) { FlushPending(); });
+}
+
+void ScheduleFlushLocked()
+{
+    // Only the first pending write arms the window; later writes ride along with it.
+    if (!k_work_delayable_is_pending(&sFlushWork))
+    {
+        (void) k_work_schedule(&sFlushWork, K_MSEC(CONFIG_SOIL_SETTINGS_WRITEBACK_WINDOW_MS));
+    }
+}
+
+// Returns true if the value was deferred; false if the caller must write it through.
+bool Defer(Target target, const char * key, const void * data, size_t len)
+{
+    if (!sInitialized || len > kMaxValueSize || strlen(key) > kMaxKeyLength)
+    {
+        return false;
+    }
+
+    k_mutex_lock(&sLock, K_FOREVER);
+    Slot * slot = FindSlot(target, key);
+    if (slot != nullptr)
+    {
+        sStats.coalescedWrites++;
+    }
+    else
+    {
+        slot = AllocateSlot();
+    }
+
+    if (slot == nullptr)
+    {
+        sStats.writeThroughs++;
+        k_mutex_unlock(&sLock);
+        return false;
+    }
+
+    slot->used   = true;
+    slot->target = target;
+    slot->len    = static_cast<uint16_t>(len);
+    strncpy(slot->key, key, sizeof(slot->key) - 1);
+    slot->key[sizeof(slot->key) - 1] = '\0';
+    memcpy(slot->data, data, len);
+    ScheduleFlushLocked();
+    k_mutex_unlock(&sLock);
+    return true;
+}
+
+// Drops a pending value; returns true if one was pending.
+bool Forget(Target target, const char * key)
+{
+    k_mutex_lock(&sLock, K_FOREVER);
+    Slot * slot = FindSlot(target, key);
+    if (slot != nullptr)
+    {
+        slot->used = false;
+    }
+    k_mutex_unlock(&sLock);
+    return slot != nullptr;
+}
+
+} // namespace
+
+void Init()
+{
+    if (sInitialized)
+    {
+        return;
+    }
+    k_work_init_delayable(&sFlushWork, FlushWorkHandler);
+    sInitialized = true;
+}
+
+int Write(const char * key, const void * data, size_t len)
+{
+    RecordRequest(key, len);
+    if (Defer(Target::Settings, key, data, len))
+    {
+        return 0;
+    }
+    return WriteSettings(key, data, len);
+}
+
+int Delete(const char * key)
+{
+    (void) Forget(Target::Settings, key);
+    return settings_delete(key);
+}
+
+void FlushNow()
+{
+    (void) k_work_cancel_delayable(&sFlushWork);
+    FlushPending();
+}
+
+void FlushAfterFault()
+{
+    (void) k_work_cancel_delayable(&sFlushWork);
+
+    // An aborted thread never releases its mutexes; finding one taken means skipping the flush.
+    if (k_mutex_lock(&sLock, K_NO_WAIT) != 0)
+    {
+        return;
+    }
+#if defined(CONFIG_SETTINGS_NVS)
+    void * storage = nullptr;
+    if (settings_storage_get(&storage) == 0 && storage != nullptr)
+    {
+        k_mutex * nvsLock = &static_cast<nvs_fs *>(storage)->nvs_lock;
+        if (k_mutex_lock(nvsLock, K_NO_WAIT) != 0)
+        {
+            k_mutex_unlock(&sLock);
+            return;
+        }
+        k_mutex_unlock(nvsLock);
+    }
+#endif
+
+    for (Slot & slot : sSlots)
+    {
+        if (slot.used && slot.target == Target::Settings)
+        {
+            (void) settings_save_one(slot.key, slot.data, slot.len);
+        }
+        slot.used = false;
+    }
+    k_mutex_unlock(&sLock);
+}
+
+void Discard()
+{
+    (void) k_work_cancel_delayable(&sFlushWork);
+
+    k_mutex_lock(&sLock, K_FOREVER);
+    for (Slot & slot : sSlots)
+    {
+        slot.used = false;
+    }
+    k_mutex_unlock(&sLock);
+}
+
+Stats GetStats()
+{
+    k_mutex_lock(&sLock, K_FOREVER);
+    const Stats stats = sStats;
+    k_mutex_unlock(&sLock);
+    return stats;
+}
+
+size_t GetKeyStats(KeyStats * out, size_t maxCount)
+{
+    k_mutex_lock(&sLock, K_FOREVER);
+    const size_t count = (sKeyStatsCount < maxCount) ? sKeyStatsCount : maxCount;
+    memcpy(out, sKeyStats, count * sizeof(KeyStats));
+    k_mutex_unlock(&sLock);
+    return count;
+}
+
+void LogStats()
+{
+    KeyStats keys[kMaxTrackedKeys];
+    const Stats stats  = GetStats();
+    const size_t count = GetKeyStats(keys, kMaxTrackedKeys);
+
+    LOG_INF("Settings write-back: %u requested, %u coalesced, %u flash writes (%u B), %u flushes, %u write-through",
+            stats.requestedWrites, stats.coalescedWrites, stats.flashWrites, stats.flashBytes, stats.flushes,
+            stats.writeThroughs);
+    for (size_t i = 0; i < count; i++)
+    {
+        LOG_INF("  %s: %u/%u writes, %u/%u B (requested/flash)", keys[i].key, keys[i].requestedWrites, keys[i].flashWrites,
+                keys[i].requestedBytes, keys[i].flashBytes);
+    }
+}
+
+WriteBackStorageDelegate::WriteBackStorageDelegate(chip::PersistentStorageDelegate & inner) : mInner(&inner)
+{
+    // Deferred Matter writes are flushed through the one delegate handed to the server.
+    sMatterStorage = &inner;
+}
+
+CHIP_ERROR WriteBackStorageDelegate::SyncGetKeyValue(const char * key, void * buffer, uint16_t & size)
+{
+    VerifyOrReturnError(key != nullptr && (buffer != nullptr || size == 0), CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Read-your-writes: a pending value is newer than whatever is in flash.
+    k_mutex_lock(&sLock, K_FOREVER);
+    const Slot * slot = FindSlot(Target::Matter, key);
+    if (slot == nullptr)
+    {
+        k_mutex_unlock(&sLock);
+        return mInner->SyncGetKeyValue(key, buffer, size);
+    }
+
+    const uint16_t available = size;
+    size                     = slot->len;
+    const uint16_t copyLen   = (slot->len < available) ? slot->len : available;
+    memcpy(buffer, slot->data, copyLen);
+    k_mutex_unlock(&sLock);
+
+    return (size > available) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteBackStorageDelegate::SyncSetKeyValue(const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(key != nullptr && (value != nullptr || size == 0), CHIP_ERROR_INVALID_ARGUMENT);
+
+    RecordRequest(key, size);
+    if (IsDeferrableMatterKey(key) && Defer(Target::Matter, key, value, size))
+    {
+        return CHIP_NO_ERROR;
+    }
+    return WriteMatter(key, value, size);
+}
+
+CHIP_ERROR WriteBackStorageDelegate::SyncDeleteKeyValue(const char * key)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Deletes are written through; a pending value for the key is simply superseded.
+    const bool wasPending = Forget(Target::Matter, key);
+    CHIP_ERROR err        = mInner->SyncDeleteKeyValue(key);
+    if (wasPending && err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        return CHIP_NO_ERROR;
+    }
+    return err;
+}
+
+} // namespace settings_writeback
+} // namespace cfg
@@ -1,19 +1,283 @@
 #include "connectivity/ble_manager.h"
 
+#include "diag/heap_stats.h"
+#include "matter/access_manager.h"
+
+#include <app/server/Server.h>
+#include <credentials/FabricTable.h>
+#include <lib/core/ErrorStr.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <platform/ConfigurationManager.h>
 #include <platform/internal/BLEManager.h>
 #include <platform/nrfconnect/DeviceInstanceInfoProviderImpl.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
 #include <zephyr/sys/printk.h>
 
+#include <cerrno>
+
 LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
 
+#ifndef CONFIG_SOIL_BLE_ADV_FAST_MS
+#define CONFIG_SOIL_BLE_ADV_FAST_MS 30000
+#endif
+
 namespace connectivity
 {
 namespace ble_manager
 {
 
+namespace
+{
+
+// PASE and certificate transfer are chatty request/response exchanges over BTP; a short interval
+// matters more than throughput per event. 15-30 ms, no latency, 4 s supervision timeout. Data
+// length and 2M PHY are negotiated by the host on connect (BT_AUTO_DATA_LEN_UPDATE/PHY_UPDATE).
+constexpr uint16_t kConnIntervalMin = 12; // 1.25 ms units
+constexpr uint16_t kConnIntervalMax = 24;
+constexpr uint16_t kConnLatency     = 0;
+constexpr uint16_t kConnTimeout     = 400; // 10 ms units
+
+void OnConnected(bt_conn * conn, uint8_t err)
+{
+    if (err != 0)
+    {
+        return;
+    }
+
+    // Centrals open at a conservative 30-50 ms interval; ask for a faster one straight away
+    // instead of waiting for the GAP connection parameter update timer.
+    const bt_le_conn_param param = BT_LE_CONN_PARAM_INIT(kConnIntervalMin, kConnIntervalMax, kConnLatency, kConnTimeout);
+    int rc                       = bt_conn_le_param_update(conn, &param);
+    if (rc != 0)
+    {
+        LOG_WRN("BLE connection parameter request failed: %d", rc);
+    }
+}
+
+void OnParamUpdated(bt_conn *, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+    LOG_INF("BLE link: interval %u us, latency %u, timeout %u ms", interval * 1250U, latency, timeout * 10U);
+}
+
+void OnPhyUpdated(bt_conn *, bt_conn_le_phy_info * info)
+{
+    LOG_INF("BLE link: tx phy %u, rx phy %u", info->tx_phy, info->rx_phy);
+}
+
+void OnDataLenUpdated(bt_conn *, bt_conn_le_data_len_info * info)
+{
+    LOG_INF("BLE link: tx %u B / %u us, rx %u B / %u us", info->tx_max_len, info->tx_max_time, info->rx_max_len,
+            info->rx_max_time);
+}
+
+void OnAttMtuUpdated(bt_conn *, uint16_t tx, uint16_t rx)
+{
+    // BTP fragments are sized from the ATT MTU, so this sets the commissioning payload per packet.
+    LOG_INF("BLE link: ATT MTU tx %u, rx %u", tx, rx);
+}
+
+BT_CONN_CB_DEFINE(sConnCallbacks) = {
+    .connected           = OnConnected,
+    .le_param_updated    = OnParamUpdated,
+    .le_phy_updated      = OnPhyUpdated,
+    .le_data_len_updated = OnDataLenUpdated,
+};
+
+bt_gatt_cb sGattCallbacks = {
+    .att_mtu_updated = OnAttMtuUpdated,
+};
+
+enum class AdvPhase : uint8_t
+{
+    Off,
+    Fast,
+    Slow,
+};
+
+constexpr uint32_t kFastPhaseMs = CONFIG_SOIL_BLE_ADV_FAST_MS;
+
+// Owned by the CHIP thread.
+AdvPhase sPhase             = AdvPhase::Off;
+int64_t sAdvertisingSinceMs = 0; // 0 = not advertising
+Stats sStats                = {};
+
+// Charges the advertising time since the last call to the current phase.
+void Account()
+{
+    if (sAdvertisingSinceMs == 0)
+    {
+        return;
+    }
+
+    const int64_t now    = k_uptime_get();
+    const uint32_t spent = static_cast<uint32_t>(now - sAdvertisingSinceMs);
+    sAdvertisingSinceMs  = now;
+    if (sPhase == AdvPhase::Fast)
+    {
+        sStats.fastMs += spent;
+    }
+    else if (sPhase == AdvPhase::Slow)
+    {
+        sStats.slowMs += spent;
+    }
+}
+
+void EnterPhase(AdvPhase phase);
+void MaybeTeardown();
+
+void FastPhaseTimeout(chip::System::Layer *, void *)
+{
+    if (sPhase == AdvPhase::Fast)
+    {
+        EnterPhase(AdvPhase::Slow);
+    }
+}
+
+void EnterPhase(AdvPhase phase)
+{
+    using chip::DeviceLayer::ConnectivityMgr;
+    using chip::DeviceLayer::ConnectivityManager;
+
+    Account();
+    sPhase = phase;
+    chip::DeviceLayer::SystemLayer().CancelTimer(FastPhaseTimeout, nullptr);
+
+    switch (phase)
+    {
+    case AdvPhase::Fast:
+        sStats.windows++;
+        (void) ConnectivityMgr().SetBLEAdvertisingMode(ConnectivityManager::kFastAdvertising);
+        (void) ConnectivityMgr().SetBLEAdvertisingEnabled(true);
+        (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(kFastPhaseMs),
+                                                           FastPhaseTimeout, nullptr);
+        LOG_INF("BLE advertising: fast for %u ms", static_cast<unsigned>(kFastPhaseMs));
+        break;
+    case AdvPhase::Slow:
+        (void) ConnectivityMgr().SetBLEAdvertisingMode(ConnectivityManager::kSlowAdvertising);
+        LOG_INF("BLE advertising: slow");
+        break;
+    case AdvPhase::Off:
+        (void) ConnectivityMgr().SetBLEAdvertisingEnabled(false);
+        LogStats();
+        MaybeTeardown();
+        break;
+    }
+}
+
+bool WindowOpen()
+{
+    return chip::Server::GetInstance().GetCommissioningWindowManager().IsCommissioningWindowOpen();
+}
+
+// Windows opened by a controller on a commissioned device are DNS-SD only; the commissioning
+// window manager enables BLE advertising just for the ones that advertise over BLE.
+bool BleWindowOpen()
+{
+    return WindowOpen() && chip::DeviceLayer::Internal::BLEMgr().IsAdvertisingEnabled();
+}
+
+// Owned by the CHIP thread.
+bool sBtOff = false;
+
+// The CHIP sys_heap when configured. Dev builds run without it (HEAP_MEM_POOL only) and would
+// report 0/0, so they get the kernel heap instead.
+const char * HeapName()
+{
+    return diag::heap_stats::GetStats().chip.sizeBytes != 0 ? "CHIP" : "kernel";
+}
+
+uint32_t HeapFree()
+{
+    const diag::heap_stats::Stats stats     = diag::heap_stats::GetStats();
+    const diag::heap_stats::HeapInfo & heap = stats.chip.sizeBytes != 0 ? stats.chip : stats.kernel;
+    return heap.sizeBytes - heap.usedBytes;
+}
+
+void Teardown(intptr_t)
+{
+    // A window or a connection may have come up since this was scheduled.
+    if (sBtOff || WindowOpen() || chip::DeviceLayer::Internal::BLEMgr().NumConnections() != 0)
+    {
+        return;
+    }
+
+    const uint32_t heapBefore = HeapFree();
+    int rc                    = bt_disable();
+    if (rc != 0)
+    {
+        LOG_WRN("bt_disable failed: %d", rc);
+        return;
+    }
+    sBtOff = true;
+    sStats.teardowns++;
+    sStats.heapFreeBleOn  = heapBefore;
+    sStats.heapFreeBleOff = HeapFree();
+    LOG_INF("BLE off until the next commissioning window; %s heap free %u -> %u B", HeapName(), sStats.heapFreeBleOn,
+            sStats.heapFreeBleOff);
+}
+
+void MaybeTeardown()
+{
+    if (!IS_ENABLED(CONFIG_SOIL_BLE_TEARDOWN) || sBtOff || WindowOpen() ||
+        chip::Server::GetInstance().GetFabricTable().FabricCount() == 0)
+    {
+        return;
+    }
+    // An open connection is retried on kCHIPoBLEConnectionClosed.
+    if (chip::DeviceLayer::Internal::BLEMgr().NumConnections() != 0)
+    {
+        return;
+    }
+    // Queued behind the BLE manager's own advertising stop.
+    (void) chip::DeviceLayer::PlatformMgr().ScheduleWork(Teardown);
+}
+
+void Restore()
+{
+    if (!sBtOff)
+    {
+        return;
+    }
+
+    int rc = bt_enable(nullptr);
+    if (rc != 0 && rc != -EALREADY)
+    {
+        LOG_ERR("bt_enable failed: %d", rc);
+        return;
+    }
+    sBtOff = false;
+    if (IS_ENABLED(CONFIG_BT_SETTINGS))
+    {
+        // bt_disable drops the identity; it comes back from settings with the bonds.
+        (void) settings_load_subtree("bt");
+    }
+    ConfigureDeviceName();
+    LOG_INF("BLE back on for commissioning; %s heap free %u B", HeapName(), HeapFree());
+}
+
+// The stack reopens a BLE window by itself after the last fabric is removed. It only schedules the
+// advertising start, so re-enabling Bluetooth here, in the same call, comes before it.
+class LastFabricDelegate final : public chip::FabricTable::Delegate
+{
+public:
+    void OnFabricRemoved(const chip::FabricTable & fabricTable, chip::FabricIndex) override
+    {
+        if (fabricTable.FabricCount() == 0)
+        {
+            Restore();
+        }
+    }
+};
+
+LastFabricDelegate sFabricDelegate;
+bool sFabricDelegateRegistered = false;
+
+} // namespace
+
 void ConfigureDeviceName()
 {
     chip::Ble::ChipBLEDeviceIdentificationInfo idInfo;
@@ -24,17 +288,84 @@ void ConfigureDeviceName()
     (void) chip::DeviceLayer::Internal::BLEMgr().SetDeviceName(advName);
 }
 
+void InitLinkTuning()
+{
+    bt_gatt_cb_register(&sGattCallbacks);
+}
+
 void EnableAdvertising()
 {
-    chip::DeviceLayer::ConnectivityMgr().SetBLEAdvertisingEnabled(true);
-    LOG_INF("Matter server started; BLE advertising enabled.");
+    (void) chip::DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) {
+        if (!sFabricDelegateRegistered)
+        {
+            CHIP_ERROR err            = chip::Server::GetInstance().GetFabricTable().AddFabricDelegate(&sFabricDelegate);
+            sFabricDelegateRegistered = (err == CHIP_NO_ERROR);
+            if (err != CHIP_NO_ERROR)
+            {
+                LOG_WRN("BLE fabric delegate not registered: %s", chip::ErrorStr(err));
+            }
+        }
+        // The window normally opens during server init and its event already started the phase.
+        if (BleWindowOpen() && sPhase == AdvPhase::Off)
+        {
+            EnterPhase(AdvPhase::Fast);
+        }
+        LOG_INF("Matter server started; BLE advertising %s.", sPhase == AdvPhase::Off ? "off" : "on");
+        MaybeTeardown();
+    });
+}
+
+void RequestAdvertising()
+{
+    (void) chip::DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) {
+        if (BleWindowOpen())
+        {
+            sStats.restarts++;
+            EnterPhase(AdvPhase::Fast);
+            return;
+        }
+
+        chip::Server & server = chip::Server::GetInstance();
+        if (server.GetFabricTable().FabricCount() != 0)
+        {
+            LOG_INF("BLE advertising not started: already commissioned, open a window from a controller");
+            return;
+        }
+        sStats.restarts++;
+        Restore();
+        // The window opened event starts the fast phase.
+        matter::access_manager::OpenCommissioningWindowIfNeeded(server);
+    });
 }
 
 void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
 {
     switch (event->Type)
     {
+    case chip::DeviceLayer::DeviceEventType::kCommissioningWindowOpened:
+        // Bluetooth is already back on: RequestAdvertising and the last fabric removal restore it
+        // before the window starts advertising.
+        if (BleWindowOpen())
+        {
+            EnterPhase(AdvPhase::Fast);
+        }
+        break;
+    case chip::DeviceLayer::DeviceEventType::kCommissioningWindowClosed:
+        if (sPhase != AdvPhase::Off)
+        {
+            EnterPhase(AdvPhase::Off);
+        }
+        break;
     case chip::DeviceLayer::DeviceEventType::kCHIPoBLEAdvertisingChange:
+        if (event->CHIPoBLEAdvertisingChange.Result == chip::DeviceLayer::kActivity_Started)
+        {
+            sAdvertisingSinceMs = (sAdvertisingSinceMs != 0) ? sAdvertisingSinceMs : k_uptime_get();
+        }
+        else if (event->CHIPoBLEAdvertisingChange.Result == chip::DeviceLayer::kActivity_Stopped)
+        {
+            Account();
+            sAdvertisingSinceMs = 0;
+        }
         LOG_INF("BLE adv change: result=%d enabled=%d adv=%d conns=%u",
                 static_cast<int>(event->CHIPoBLEAdvertisingChange.Result),
                 static_cast<int>(chip::DeviceLayer::Internal::BLEMgr().IsAdvertisingEnabled()),
@@ -46,11 +377,28 @@ void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
         break;
     case chip::DeviceLayer::DeviceEventType::kCHIPoBLEConnectionClosed:
         LOG_INF("BLE connection closed");
+        MaybeTeardown();
         break;
     default:
         break;
     }
 }
 
+Stats GetStats()
+{
+    return sStats;
+}
+
+void LogStats()
+{
+    LOG_INF("BLE advertising: %u windows, %u restarts, fast %u ms, slow %u ms", sStats.windows, sStats.restarts,
+            sStats.fastMs, sStats.slowMs);
+    if (sStats.teardowns != 0)
+    {
+        LOG_INF("BLE teardowns: %u, %s heap free %u B with BLE on, %u B off", sStats.teardowns, HeapName(),
+                sStats.heapFreeBleOn, sStats.heapFreeBleOff);
+    }
+}
+
 } // namespace ble_manager
 } // namespace connectivity
@@ -0,0 +1,96 @@
+#include "connectivity/thread_sed.h"
+
+#include <lib/core/ErrorStr.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <zephyr/logging/log.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDNotifier.h>
+#endif
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace connectivity
+{
+namespace thread_sed
+{
+
+namespace
+{
+
+Stats sStats = {};
+
+} // namespace
+
+CHIP_ERROR Init()
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_THREAD
+    using chip::DeviceLayer::ConnectivityManager;
+
+    CHIP_ERROR err = chip::DeviceLayer::ThreadStackMgr().InitThreadStack();
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_ERR("Thread stack init failed: %s", chip::ErrorStr(err));
+        return err;
+    }
+
+    // Never a router: a battery sensor must not be asked to forward traffic or stay awake for children.
+    const auto deviceType = IS_ENABLED(CONFIG_CHIP_THREAD_SSED) ? ConnectivityManager::kThreadDeviceType_SynchronizedSleepyEndDevice
+                                                                : ConnectivityManager::kThreadDeviceType_SleepyEndDevice;
+    err = chip::DeviceLayer::ConnectivityMgr().SetThreadDeviceType(deviceType);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_ERR("Setting Thread device type failed: %s", chip::ErrorStr(err));
+        return err;
+    }
+    sStats.sleepy = true;
+    LOG_INF("Thread stack up as %s end device", IS_ENABLED(CONFIG_CHIP_THREAD_SSED) ? "synchronized sleepy" : "sleepy");
+#endif
+    return CHIP_NO_ERROR;
+}
+
+void BeginBurst()
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_THREAD && CHIP_CONFIG_ENABLE_ICD_SERVER
+    sStats.bursts++;
+    chip::app::ICDNotifier::GetInstance().NotifyNetworkActivityNotification();
+#endif
+}
+
+void OnThreadStateChange()
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_THREAD
+    using chip::DeviceLayer::ConnectivityManager;
+
+    const bool attached = chip::DeviceLayer::ConnectivityMgr().IsThreadAttached();
+    const auto type     = chip::DeviceLayer::ConnectivityMgr().GetThreadDeviceType();
+    sStats.sleepy       = (type == ConnectivityManager::kThreadDeviceType_SleepyEndDevice ||
+                           type == ConnectivityManager::kThreadDeviceType_SynchronizedSleepyEndDevice);
+
+    if (attached == sStats.attached)
+    {
+        return;
+    }
+    sStats.attached = attached;
+
+    if (attached)
+    {
+        sStats.attaches++;
+        LOG_INF("Thread attached as %s (attach #%u)", sStats.sleepy ? "sleepy end device" : "non-sleepy device",
+                static_cast<unsigned>(sStats.attaches));
+    }
+    else
+    {
+        sStats.detaches++;
+        LOG_WRN("Thread detached (%u times since boot)", static_cast<unsigned>(sStats.detaches));
+    }
+#endif
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+} // namespace thread_sed
+} // namespace connectivity
@@ -0,0 +1,318 @@
+#include "connectivity/wifi_power_policy.h"
+
+#include "matter/vendor_diagnostics.h"
+
+#include <app/InteractionModelEngine.h>
+#include <lib/core/ErrorStr.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <system/SystemClock.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+#include <zephyr/sys/atomic.h>
+
+#include <algorithm>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+#ifndef CONFIG_SOIL_WIFI_PS_LISTEN_INTERVAL
+#define CONFIG_SOIL_WIFI_PS_LISTEN_INTERVAL 10
+#endif
+
+#ifndef CONFIG_SOIL_WIFI_PS_BURST_HOLD_MS
+#define CONFIG_SOIL_WIFI_PS_BURST_HOLD_MS 1000
+#endif
+
+namespace connectivity
+{
+namespace wifi_power_policy
+{
+
+namespace
+{
+
+using chip::DeviceLayer::DeviceEventType;
+
+constexpr uint8_t kSnapshotVersion = 1;
+
+// Owned by the CHIP thread.
+bool sBurst         = false;
+bool sCommissioning = false;
+bool sOta           = false;
+State sState        = State::Idle;
+int64_t sEnteredMs  = 0;
+Stats sStats        = {};
+
+// Handed to the system work queue, which owns the net_mgmt calls and everything below.
+atomic_t sDesiredMode = ATOMIC_INIT(static_cast<atomic_val_t>(Mode::Active));
+atomic_t sNeedWakeupParams = ATOMIC_INIT(1);
+atomic_t sApplyFailures;
+k_work sApplyWork;
+
+// Mode time follows what the driver accepted, not what was asked for: a refused or still queued
+// request leaves the radio in its previous mode. Written by the work queue, read by the CHIP thread.
+// Power save is only counted once a request for it succeeded.
+k_spinlock sModeLock;
+Mode sAppliedMode      = Mode::Active;
+int64_t sModeEnteredMs = 0;
+
+// Caller holds sModeLock.
+void AccountMode(int64_t nowMs)
+{
+    sStats.modeMs[static_cast<uint8_t>(sAppliedMode)] += static_cast<uint32_t>(nowMs - sModeEnteredMs);
+    sModeEnteredMs = nowMs;
+}
+
+Mode ModeFor(State state)
+{
+    return (state == State::Idle) ? Mode::PowerSave : Mode::Active;
+}
+
+int RequestPs(wifi_ps_params & params)
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_POWER_POLICY)
+    net_if * iface = net_if_get_first_wifi();
+    if (iface == nullptr)
+    {
+        return -ENODEV;
+    }
+    return net_mgmt(NET_REQUEST_WIFI_PS, iface, &params, sizeof(params));
+#else
+    // Thread builds have no Wi-Fi management layer to link against.
+    ARG_UNUSED(params);
+    return -ENOTSUP;
+#endif
+}
+
+int ApplyListenInterval()
+{
+    wifi_ps_params params  = {};
+    params.type            = WIFI_PS_PARAM_LISTEN_INTERVAL;
+    params.listen_interval = CONFIG_SOIL_WIFI_PS_LISTEN_INTERVAL;
+    int rc                 = RequestPs(params);
+    if (rc == 0)
+    {
+        params             = {};
+        params.type        = WIFI_PS_PARAM_WAKEUP_MODE;
+        params.wakeup_mode = WIFI_PS_WAKEUP_MODE_LISTEN_INTERVAL;
+        rc                 = RequestPs(params);
+    }
+    return rc;
+}
+
+void ApplyHandler(k_work *)
+{
+    const Mode desired = static_cast<Mode>(atomic_get(&sDesiredMode));
+
+    // The wakeup settings only stick once associated; retried on the next transition if refused.
+    if (atomic_cas(&sNeedWakeupParams, 1, 0) && ApplyListenInterval() != 0)
+    {
+        atomic_set(&sNeedWakeupParams, 1);
+    }
+
+    wifi_ps_params params = {};
+    params.type           = WIFI_PS_PARAM_STATE;
+    params.enabled        = (desired == Mode::PowerSave) ? WIFI_PS_ENABLED : WIFI_PS_DISABLED;
+    const int rc          = RequestPs(params);
+    if (rc != 0)
+    {
+        LOG_DBG("Wi-Fi power save %s failed: %d (reason %d)", desired == Mode::PowerSave ? "on" : "off", rc,
+                static_cast<int>(params.fail_reason));
+        atomic_inc(&sApplyFailures);
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&sModeLock);
+    AccountMode(k_uptime_get());
+    sAppliedMode = desired;
+    k_spin_unlock(&sModeLock, key);
+}
+
+void Account(int64_t nowMs)
+{
+    const uint32_t elapsed = static_cast<uint32_t>(nowMs - sEnteredMs);
+    sStats.stateMs[static_cast<uint8_t>(sState)] += elapsed;
+    sEnteredMs = nowMs;
+}
+
+// A changed value is reported no sooner than each subscription's min interval, and the burst has to
+// outlast the report it was started for. Held for the longest min interval among the subscriptions,
+// and never less than CONFIG_SOIL_WIFI_PS_BURST_HOLD_MS for the acknowledgements.
+uint32_t BurstHoldMs()
+{
+    using chip::app::ReadHandler;
+
+    uint32_t holdMs                            = CONFIG_SOIL_WIFI_PS_BURST_HOLD_MS;
+    chip::app::InteractionModelEngine * engine = chip::app::InteractionModelEngine::GetInstance();
+    for (uint32_t i = 0; i < engine->GetNumActiveReadHandlers(); i++)
+    {
+        ReadHandler * handler = engine->ActiveHandlerAt(i);
+        if (handler == nullptr || !handler->IsType(ReadHandler::InteractionType::Subscribe))
+        {
+            continue;
+        }
+        uint16_t minIntervalS = 0;
+        uint16_t maxIntervalS = 0;
+        handler->GetReportingIntervals(minIntervalS, maxIntervalS);
+        holdMs = std::max<uint32_t>(holdMs, minIntervalS * 1000U);
+    }
+    return holdMs;
+}
+
+void Update()
+{
+    if (!IS_ENABLED(CONFIG_SOIL_WIFI_POWER_POLICY))
+    {
+        return;
+    }
+
+    State next = State::Idle;
+    if (sOta)
+    {
+        next = State::Ota;
+    }
+    else if (sCommissioning)
+    {
+        next = State::Commissioning;
+    }
+    else if (sBurst)
+    {
+        next = State::Burst;
+    }
+
+    if (next == sState)
+    {
+        return;
+    }
+
+    Account(k_uptime_get());
+    sState = next;
+    sStats.transitions++;
+
+    atomic_set(&sDesiredMode, static_cast<atomic_val_t>(ModeFor(next)));
+    (void) k_work_submit(&sApplyWork);
+}
+
+void BurstExpired(chip::System::Layer *, void *)
+{
+    sBurst = false;
+    Update();
+}
+
+} // namespace
+
+void Init()
+{
+    k_work_init(&sApplyWork, ApplyHandler);
+    sEnteredMs     = k_uptime_get();
+    sModeEnteredMs = sEnteredMs;
+    sState         = State::Idle;
+    atomic_set(&sDesiredMode, static_cast<atomic_val_t>(Mode::PowerSave));
+
+    CHIP_ERROR err = matter::vendor_diagnostics::Register(matter::vendor_diagnostics::kWifiPowerPolicy, Snapshot);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_WRN("Wi-Fi power policy attribute not registered: %s", chip::ErrorStr(err));
+    }
+}
+
+void BeginBurst()
+{
+    sBurst = true;
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(BurstHoldMs()), BurstExpired,
+                                                       nullptr);
+    Update();
+}
+
+void SetCommissioning(bool active)
+{
+    sCommissioning = active;
+    Update();
+}
+
+void SetOta(bool active)
+{
+    sOta = active;
+    Update();
+}
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+    switch (event->Type)
+    {
+    case DeviceEventType::kCommissioningWindowOpened:
+        SetCommissioning(true);
+        break;
+    case DeviceEventType::kCommissioningWindowClosed:
+        SetCommissioning(false);
+        break;
+    case DeviceEventType::kOtaStateChanged:
+        SetOta(event->OtaStateChanged.newState == chip::DeviceLayer::kOtaDownloadInProgress ||
+               event->OtaStateChanged.newState == chip::DeviceLayer::kOtaApplyInProgress);
+        break;
+    case DeviceEventType::kWiFiConnectivityChange:
+        // Power-save settings do not survive a reassociation; push them again.
+        if (IS_ENABLED(CONFIG_SOIL_WIFI_POWER_POLICY) &&
+            event->WiFiConnectivityChange.Result == chip::DeviceLayer::kConnectivity_Established)
+        {
+            atomic_set(&sNeedWakeupParams, 1);
+            (void) k_work_submit(&sApplyWork);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+Stats GetStats()
+{
+    const int64_t nowMs = k_uptime_get();
+    Account(nowMs);
+
+    k_spinlock_key_t key = k_spin_lock(&sModeLock);
+    AccountMode(nowMs);
+    Stats stats = sStats;
+    stats.mode  = sAppliedMode;
+    k_spin_unlock(&sModeLock, key);
+
+    stats.applyFailures = static_cast<uint32_t>(atomic_get(&sApplyFailures));
+    stats.state         = sState;
+    return stats;
+}
+
+void LogStats()
+{
+    const Stats stats = GetStats();
+    LOG_INF("Wi-Fi PS: idle %u s, burst %u s, commissioning %u s, OTA %u s; power save %u s, active %u s; "
+            "%u transitions, %u failed requests",
+            stats.stateMs[0] / 1000, stats.stateMs[1] / 1000, stats.stateMs[2] / 1000, stats.stateMs[3] / 1000,
+            stats.modeMs[0] / 1000, stats.modeMs[1] / 1000, stats.transitions, stats.applyFailures);
+}
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out)
+{
+    const Stats stats = GetStats();
+
+    chip::Encoding::LittleEndian::BufferWriter writer(out.data(), out.size());
+    writer.Put8(kSnapshotVersion).Put8(static_cast<uint8_t>(stats.state)).Put8(static_cast<uint8_t>(stats.mode)).Put8(0);
+    for (uint32_t stateMs : stats.stateMs)
+    {
+        writer.Put32(stateMs);
+    }
+    for (uint32_t modeMs : stats.modeMs)
+    {
+        writer.Put32(modeMs);
+    }
+    writer.Put32(stats.transitions).Put32(stats.applyFailures);
+
+    size_t written = 0;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+    out.reduce_size(written);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace wifi_power_policy
+} // namespace connectivity
@@ -0,0 +1,619 @@
+#include "connectivity/wifi_reconnect.h"
+
+#include "cfg/settings_writeback.h"
+
+#include <crypto/RandUtils.h>
+#include <lib/support/Span.h>
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+#include <platform/nrfconnect/wifi/NrfWiFiDriver.h>
+#endif
+#include <system/SystemClock.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+#include <zephyr/settings/settings.h>
+
+#include <algorithm>
+#include <cstring>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+#ifndef CONFIG_SOIL_WIFI_RECONNECT_WEAK_RSSI
+#define CONFIG_SOIL_WIFI_RECONNECT_WEAK_RSSI -75
+#endif
+
+#ifndef CONFIG_SOIL_WIFI_RECONNECT_ATTEMPT_TIMEOUT_MS
+#define CONFIG_SOIL_WIFI_RECONNECT_ATTEMPT_TIMEOUT_MS 15000
+#endif
+
+namespace connectivity
+{
+namespace wifi_reconnect
+{
+
+namespace
+{
+
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+
+constexpr uint32_t kMinIntervalMs    = CONFIG_CHIP_WIFI_CONNECTION_RECOVERY_MINIMUM_INTERVAL;
+constexpr uint32_t kMaxIntervalMs    = CONFIG_CHIP_WIFI_CONNECTION_RECOVERY_MAXIMUM_INTERVAL;
+constexpr uint32_t kJitterMs         = CONFIG_CHIP_WIFI_CONNECTION_RECOVERY_JITTER;
+constexpr uint32_t kAttemptTimeoutMs = CONFIG_SOIL_WIFI_RECONNECT_ATTEMPT_TIMEOUT_MS;
+// Association on a known channel takes well under a second; give up early and scan instead.
+constexpr uint32_t kDirectedTimeoutMs = 5000;
+constexpr uint8_t kHistoryLength      = 8;
+constexpr uint8_t kReliablePercent    = 75;
+constexpr uint8_t kMaxBackoffShift    = 16;
+constexpr uint32_t kLogEveryOutages   = 10;
+
+constexpr char kSettingsKey[]       = "soil/wifi";
+constexpr char kCredentialsKey[]    = "soil/wifi-cred";
+constexpr uint8_t kPersistedVersion = 1;
+
+struct Link
+{
+    uint8_t bssid[WIFI_MAC_ADDR_LEN];
+    uint8_t channel;
+    uint8_t band;
+    wifi_security_type security;
+    int8_t rssi;
+    uint8_t ssid[WIFI_SSID_MAX_LEN];
+    uint8_t ssidLen;
+};
+
+struct PersistedLink
+{
+    uint8_t version;
+    uint8_t channel;
+    uint8_t band;
+    uint8_t security;
+    uint8_t ssidLen;
+    uint8_t bssid[WIFI_MAC_ADDR_LEN];
+    uint8_t ssid[WIFI_SSID_MAX_LEN];
+};
+
+struct Credentials
+{
+    uint8_t ssid[WIFI_SSID_MAX_LEN];
+    size_t ssidLen;
+    uint8_t pass[WIFI_PSK_MAX_LEN];
+    size_t passLen;
+    bool complete; // passphrase known, so a directed connect is possible
+
+    ~Credentials() { memset(pass, 0, sizeof(pass)); }
+};
+
+// The nRF Wi-Fi driver keeps its passphrase private; this copy is taken from the network staged
+// through AddOrUpdateNetwork and persisted when the configuration is committed.
+struct PersistedCredentials
+{
+    uint8_t version;
+    uint8_t ssidLen;
+    uint8_t passLen;
+    uint8_t ssid[WIFI_SSID_MAX_LEN];
+    uint8_t pass[WIFI_PSK_MAX_LEN];
+};
+
+// Owned by the CHIP thread.
+Stats sStats                    = {};
+Link sLink                      = {};
+PersistedLink sPersisted        = {};
+bool sHaveLink                  = false;
+bool sDirectedFailed            = false;
+bool sAttemptInFlight           = false;
+bool sBootConnect               = false;
+int64_t sOutageStartMs          = 0;
+uint64_t sLatencySumMs          = 0;
+uint8_t sHistory                = 0; // bit set = outage recovered without a failed attempt, newest in bit 0
+uint8_t sHistoryCount           = 0;
+Path sPath                      = Path::Scan;
+int64_t sPathStartMs            = 0; // 0 = no attempt waiting for an address
+uint64_t sToIpSumMs[kPathCount] = {};
+PersistedCredentials sStaged    = {}; // version 0 = nothing staged
+
+net_if * WifiIface()
+{
+    return net_if_get_first_wifi();
+}
+
+bool StationIdle()
+{
+    wifi_iface_status status = {};
+    net_if * iface           = WifiIface();
+    if (iface == nullptr || net_mgmt(NET_REQUEST_WIFI_IFACE_STATUS, iface, &status, sizeof(status)) != 0)
+    {
+        return false;
+    }
+    return status.state <= WIFI_STATE_INACTIVE;
+}
+
+void Persist()
+{
+    PersistedLink record = {};
+    record.version       = kPersistedVersion;
+    record.channel       = sLink.channel;
+    record.band          = sLink.band;
+    record.security      = static_cast<uint8_t>(sLink.security);
+    record.ssidLen       = sLink.ssidLen;
+    memcpy(record.bssid, sLink.bssid, sizeof(record.bssid));
+    memcpy(record.ssid, sLink.ssid, sizeof(record.ssid));
+
+    // Roaming between the same APs would otherwise rewrite the record on every reconnect.
+    if (memcmp(&record, &sPersisted, sizeof(record)) == 0)
+    {
+        return;
+    }
+
+    int rc = cfg::settings_writeback::Write(kSettingsKey, &record, sizeof(record));
+    if (rc != 0)
+    {
+        LOG_WRN("Failed to persist Wi-Fi link: %d", rc);
+        return;
+    }
+    sPersisted = record;
+}
+
+template <typename Record>
+int LoadPersisted(const char * key, size_t len, settings_read_cb readCb, void * cbArg, void * param)
+{
+    auto * record = static_cast<Record *>(param);
+    if (key != nullptr || len != sizeof(*record))
+    {
+        return 0;
+    }
+
+    if (readCb(cbArg, record, sizeof(*record)) != static_cast<ssize_t>(sizeof(*record)))
+    {
+        memset(record, 0, sizeof(*record));
+    }
+    return 0;
+}
+
+void Restore()
+{
+    PersistedLink record = {};
+    (void) settings_load_subtree_direct(kSettingsKey, LoadPersisted<PersistedLink>, &record);
+    if (record.version != kPersistedVersion || record.ssidLen == 0 || record.ssidLen > sizeof(record.ssid))
+    {
+        return;
+    }
+
+    memcpy(sLink.bssid, record.bssid, sizeof(sLink.bssid));
+    memcpy(sLink.ssid, record.ssid, sizeof(sLink.ssid));
+    sLink.ssidLen  = record.ssidLen;
+    sLink.channel  = record.channel;
+    sLink.band     = record.band;
+    sLink.security = static_cast<wifi_security_type>(record.security);
+    sLink.rssi     = 0;
+    sPersisted     = record;
+    sHaveLink      = true;
+}
+
+void CaptureLink()
+{
+    wifi_iface_status status = {};
+    net_if * iface           = WifiIface();
+    if (iface == nullptr || net_mgmt(NET_REQUEST_WIFI_IFACE_STATUS, iface, &status, sizeof(status)) != 0 ||
+        status.state != WIFI_STATE_COMPLETED)
+    {
+        return;
+    }
+
+    memcpy(sLink.bssid, status.bssid, sizeof(sLink.bssid));
+    memcpy(sLink.ssid, status.ssid, sizeof(sLink.ssid));
+    sLink.ssidLen   = static_cast<uint8_t>(std::min<size_t>(status.ssid_len, sizeof(sLink.ssid)));
+    sLink.channel   = static_cast<uint8_t>(status.channel);
+    sLink.band      = static_cast<uint8_t>(status.band);
+    sLink.security  = status.security;
+    sLink.rssi      = static_cast<int8_t>(status.rssi);
+    sStats.lastRssi = sLink.rssi;
+    sHaveLink       = true;
+    Persist();
+}
+
+// The SSID comes from the driver's network list, which is the provisioned truth; the passphrase
+// only from our own record, and only while it belongs to that SSID.
+bool LoadCredentials(Credentials & creds)
+{
+    chip::DeviceLayer::NetworkCommissioning::NetworkIterator * networks =
+        chip::DeviceLayer::NetworkCommissioning::NrfWiFiDriver::Instance().GetNetworks();
+    if (networks == nullptr)
+    {
+        return false;
+    }
+    chip::DeviceLayer::NetworkCommissioning::Network network;
+    const bool found = networks->Next(network);
+    networks->Release();
+    if (!found || network.networkIDLen == 0 || network.networkIDLen > sizeof(creds.ssid))
+    {
+        return false;
+    }
+    memcpy(creds.ssid, network.networkID, network.networkIDLen);
+    creds.ssidLen = network.networkIDLen;
+
+    PersistedCredentials record = {};
+    (void) settings_load_subtree_direct(kCredentialsKey, LoadPersisted<PersistedCredentials>, &record);
+    if (record.version == kPersistedVersion && record.ssidLen == creds.ssidLen && record.passLen <= sizeof(creds.pass) &&
+        memcmp(record.ssid, creds.ssid, creds.ssidLen) == 0)
+    {
+        memcpy(creds.pass, record.pass, record.passLen);
+        creds.passLen  = record.passLen;
+        creds.complete = true;
+    }
+    memset(&record, 0, sizeof(record));
+    return true;
+}
+
+// The cached link belongs to whatever network was joined last; a re-commissioned SSID must scan.
+bool CanConnectDirected(const Credentials & creds)
+{
+    return creds.complete && sHaveLink && !sDirectedFailed && sLink.ssidLen == creds.ssidLen &&
+        memcmp(sLink.ssid, creds.ssid, creds.ssidLen) == 0;
+}
+
+void RecordOutcome(bool cleanRecovery)
+{
+    sHistory = static_cast<uint8_t>((sHistory << 1) | (cleanRecovery ? 1 : 0));
+    if (sHistoryCount < kHistoryLength)
+    {
+        sHistoryCount++;
+    }
+}
+
+uint8_t ReliabilityPercent()
+{
+    if (sHistoryCount == 0)
+    {
+        return 0;
+    }
+    const uint8_t mask = static_cast<uint8_t>((1u << sHistoryCount) - 1);
+    return static_cast<uint8_t>(__builtin_popcount(sHistory & mask) * 100 / sHistoryCount);
+}
+
+uint32_t NextBackoffMs()
+{
+    uint64_t delayMs = static_cast<uint64_t>(kMinIntervalMs)
+        << std::min<uint32_t>(sStats.consecutiveFailures, kMaxBackoffShift);
+
+    // Outages on this link have been short; the AP is probably back already.
+    if (sStats.consecutiveFailures == 0 && ReliabilityPercent() >= kReliablePercent)
+    {
+        delayMs /= 2;
+    }
+    // At the edge of coverage most attempts fail anyway, and each one keeps the radio on.
+    if (sHaveLink && sLink.rssi < CONFIG_SOIL_WIFI_RECONNECT_WEAK_RSSI)
+    {
+        delayMs *= 2;
+    }
+    delayMs = std::min<uint64_t>(delayMs, kMaxIntervalMs);
+
+    // Half fixed, half random, so devices that lost the same AP at the same moment fan out.
+    const uint32_t half = static_cast<uint32_t>(delayMs / 2);
+    return half + chip::Crypto::GetRandU32() % (half + 1) + chip::Crypto::GetRandU32() % (kJitterMs + 1);
+}
+
+int ConnectDirected(const Credentials & creds)
+{
+    net_if * iface = WifiIface();
+    if (iface == nullptr)
+    {
+        return -ENODEV;
+    }
+
+    wifi_connect_req_params params = {};
+    params.ssid                    = creds.ssid;
+    params.ssid_length             = static_cast<uint8_t>(creds.ssidLen);
+    params.security                = sLink.security;
+    params.channel                 = sLink.channel;
+    params.band                    = sLink.band;
+    params.mfp                     = WIFI_MFP_OPTIONAL;
+    params.timeout                 = static_cast<int>(kAttemptTimeoutMs / 1000);
+    memcpy(params.bssid, sLink.bssid, sizeof(params.bssid));
+    if (creds.passLen > 0)
+    {
+        params.psk                 = creds.pass;
+        params.psk_length          = static_cast<uint8_t>(creds.passLen);
+        params.sae_password        = creds.pass;
+        params.sae_password_length = static_cast<uint8_t>(creds.passLen);
+    }
+    return net_mgmt(NET_REQUEST_WIFI_CONNECT, iface, &params, sizeof(params));
+}
+
+void ScheduleAttempt();
+
+void AttemptTimedOut(chip::System::Layer *, void *)
+{
+    if (!sAttemptInFlight)
+    {
+        return;
+    }
+    sAttemptInFlight = false;
+    sPathStartMs     = 0;
+    sStats.failures++;
+    sStats.consecutiveFailures++;
+    ScheduleAttempt();
+}
+
+void BeginPath(Path path)
+{
+    sPath        = path;
+    sPathStartMs = k_uptime_get();
+    sStats.paths[static_cast<uint8_t>(path)].attempts++;
+}
+
+void StartAttempt(const Credentials & creds)
+{
+    sStats.attempts++;
+    bool directed = false;
+    if (CanConnectDirected(creds))
+    {
+        // Only one directed try per outage: the AP may have moved channel or been replaced.
+        sDirectedFailed = true;
+        directed        = (ConnectDirected(creds) == 0);
+    }
+
+    if (directed)
+    {
+        BeginPath(Path::Directed);
+    }
+    else
+    {
+        BeginPath(Path::Scan);
+        chip::DeviceLayer::NetworkCommissioning::NrfWiFiDriver::Instance().ConnectNetwork(
+            chip::ByteSpan(creds.ssid, creds.ssidLen), nullptr);
+    }
+
+    sAttemptInFlight = true;
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(
+        chip::System::Clock::Milliseconds32(directed ? kDirectedTimeoutMs : kAttemptTimeoutMs), AttemptTimedOut, nullptr);
+}
+
+void Attempt(chip::System::Layer *, void *)
+{
+    if (sOutageStartMs == 0 || !chip::DeviceLayer::ConnectivityMgr().IsWiFiStationProvisioned())
+    {
+        return;
+    }
+
+    // A commissioning flow or the driver's own connect is already associating; check again later.
+    if (!StationIdle())
+    {
+        ScheduleAttempt();
+        return;
+    }
+
+    Credentials creds = {};
+    if (!LoadCredentials(creds))
+    {
+        return;
+    }
+    StartAttempt(creds);
+}
+
+void ScheduleAttempt()
+{
+    sStats.lastBackoffMs = NextBackoffMs();
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(sStats.lastBackoffMs), Attempt,
+                                                       nullptr);
+}
+
+void OnLinkLost()
+{
+    if (sOutageStartMs != 0 || !chip::DeviceLayer::ConnectivityMgr().IsWiFiStationProvisioned())
+    {
+        return;
+    }
+
+    sStats.losses++;
+    sStats.consecutiveFailures = 0;
+    sOutageStartMs             = k_uptime_get();
+    sDirectedFailed            = false;
+    ScheduleAttempt();
+}
+
+void OnLinkEstablished()
+{
+    chip::DeviceLayer::SystemLayer().CancelTimer(Attempt, nullptr);
+    chip::DeviceLayer::SystemLayer().CancelTimer(AttemptTimedOut, nullptr);
+    sAttemptInFlight = false;
+    CaptureLink();
+
+    if (sOutageStartMs == 0)
+    {
+        return;
+    }
+    if (sBootConnect)
+    {
+        // Not an outage; time-to-IP for the boot connect is still recorded per path.
+        sBootConnect               = false;
+        sOutageStartMs             = 0;
+        sStats.consecutiveFailures = 0;
+        return;
+    }
+
+    const uint32_t latencyMs = static_cast<uint32_t>(k_uptime_get() - sOutageStartMs);
+    sOutageStartMs           = 0;
+    sStats.successes++;
+    sStats.lastLatencyMs = latencyMs;
+    sStats.minLatencyMs  = (sStats.successes == 1) ? latencyMs : std::min(sStats.minLatencyMs, latencyMs);
+    sStats.maxLatencyMs  = std::max(sStats.maxLatencyMs, latencyMs);
+    sLatencySumMs += latencyMs;
+    sStats.avgLatencyMs = static_cast<uint32_t>(sLatencySumMs / sStats.successes);
+    RecordOutcome(sStats.consecutiveFailures == 0);
+
+    LOG_INF("Wi-Fi back after %u ms (%u failed attempts, RSSI %d dBm)", latencyMs, sStats.consecutiveFailures,
+            sLink.rssi);
+    sStats.consecutiveFailures = 0;
+
+    if ((sStats.successes % kLogEveryOutages) == 0)
+    {
+        LogStats();
+    }
+}
+
+void OnAddressAssigned()
+{
+    if (sPathStartMs == 0)
+    {
+        return;
+    }
+
+    const uint32_t toIpMs = static_cast<uint32_t>(k_uptime_get() - sPathStartMs);
+    const uint8_t index   = static_cast<uint8_t>(sPath);
+    PathStats & path      = sStats.paths[index];
+    sPathStartMs          = 0;
+    path.reachedIp++;
+    path.lastToIpMs = toIpMs;
+    path.maxToIpMs  = std::max(path.maxToIpMs, toIpMs);
+    sToIpSumMs[index] += toIpMs;
+    path.avgToIpMs = static_cast<uint32_t>(sToIpSumMs[index] / path.reachedIp);
+
+    LOG_INF("Wi-Fi %s connect reached IPv6 in %u ms", (sPath == Path::Directed) ? "directed" : "scan", toIpMs);
+}
+
+#else
+
+Stats sStats = {};
+
+#endif // IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+
+} // namespace
+
+void Init()
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+    sStats         = {};
+    sHaveLink      = false;
+    sOutageStartMs = 0;
+    sLatencySumMs  = 0;
+    sHistory       = 0;
+    sHistoryCount  = 0;
+    Restore();
+
+    if (!chip::DeviceLayer::ConnectivityMgr().IsWiFiStationProvisioned())
+    {
+        return;
+    }
+
+    sBootConnect    = true;
+    sDirectedFailed = false;
+    sOutageStartMs  = k_uptime_get();
+
+    // Associate straight to the cached AP; if that fails the scheduler's next attempt scans.
+    Credentials creds = {};
+    if (LoadCredentials(creds) && CanConnectDirected(creds))
+    {
+        StartAttempt(creds);
+        return;
+    }
+
+    // Nothing cached to direct to: the driver's own connect to the stored network is the scan.
+    // Track it as the boot attempt, so if the AP is down the scheduler takes over on the timeout.
+    sAttemptInFlight = true;
+    BeginPath(Path::Scan);
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(kAttemptTimeoutMs),
+                                                       AttemptTimedOut, nullptr);
+#endif
+}
+
+void OnNetworkStaged(chip::ByteSpan ssid, chip::ByteSpan credentials)
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+    if (ssid.size() > sizeof(sStaged.ssid) || credentials.size() > sizeof(sStaged.pass))
+    {
+        return;
+    }
+    sStaged         = {};
+    sStaged.version = kPersistedVersion;
+    sStaged.ssidLen = static_cast<uint8_t>(ssid.size());
+    sStaged.passLen = static_cast<uint8_t>(credentials.size());
+    memcpy(sStaged.ssid, ssid.data(), ssid.size());
+    memcpy(sStaged.pass, credentials.data(), credentials.size());
+#endif
+}
+
+void OnConfigurationCommitted()
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+    if (sStaged.version == 0)
+    {
+        return;
+    }
+    // Written through, not deferred: it must not sit in the write-back cache.
+    int rc = settings_save_one(kCredentialsKey, &sStaged, sizeof(sStaged));
+    if (rc != 0)
+    {
+        LOG_WRN("Failed to persist Wi-Fi credentials: %d", rc);
+    }
+    sStaged = {};
+#endif
+}
+
+void OnConfigurationReverted()
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+    sStaged = {};
+#endif
+}
+
+void OnNetworkRemoved()
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+    sStaged = {};
+    (void) settings_delete(kCredentialsKey);
+#endif
+}
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+#if IS_ENABLED(CONFIG_SOIL_WIFI_RECONNECT)
+    using chip::DeviceLayer::DeviceEventType;
+
+    if (event->Type == DeviceEventType::kInterfaceIpAddressChanged &&
+        event->InterfaceIpAddressChanged.Type == chip::DeviceLayer::InterfaceIpChangeType::kIpV6_Assigned)
+    {
+        OnAddressAssigned();
+        return;
+    }
+    if (event->Type != DeviceEventType::kWiFiConnectivityChange)
+    {
+        return;
+    }
+
+    switch (event->WiFiConnectivityChange.Result)
+    {
+    case chip::DeviceLayer::kConnectivity_Established:
+        OnLinkEstablished();
+        break;
+    case chip::DeviceLayer::kConnectivity_Lost:
+        OnLinkLost();
+        break;
+    default:
+        break;
+    }
+#endif
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+void LogStats()
+{
+    const PathStats & directed = sStats.paths[static_cast<uint8_t>(Path::Directed)];
+    const PathStats & scan     = sStats.paths[static_cast<uint8_t>(Path::Scan)];
+    LOG_INF("Wi-Fi reconnect: %u losses, %u attempts, %u recovered, %u failed; "
+            "latency last %u / min %u / avg %u / max %u ms",
+            sStats.losses, sStats.attempts, sStats.successes, sStats.failures, sStats.lastLatencyMs, sStats.minLatencyMs,
+            sStats.avgLatencyMs, sStats.maxLatencyMs);
+    LOG_INF("Wi-Fi time to IP: directed %u/%u (avg %u, max %u ms), scan %u/%u (avg %u, max %u ms)", directed.reachedIp,
+            directed.attempts, directed.avgToIpMs, directed.maxToIpMs, scan.reachedIp, scan.attempts, scan.avgToIpMs,
+            scan.maxToIpMs);
+}
+
+} // namespace wifi_reconnect
+} // namespace connectivity
@@ -0,0 +1,301 @@
+#include "connectivity/wifi_scan_cache.h"
+
+#include "connectivity/wifi_reconnect.h"
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <system/SystemClock.h>
+
+#if defined(CONFIG_CHIP_WIFI)
+#include <platform/nrfconnect/wifi/NrfWiFiDriver.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef CONFIG_SOIL_WIFI_SCAN_CACHE_TTL_MS
+#define CONFIG_SOIL_WIFI_SCAN_CACHE_TTL_MS 10000
+#endif
+
+#ifndef CONFIG_SOIL_WIFI_SCAN_CACHE_ENTRIES
+#define CONFIG_SOIL_WIFI_SCAN_CACHE_ENTRIES 16
+#endif
+
+namespace connectivity
+{
+namespace wifi_scan_cache
+{
+
+namespace
+{
+
+Stats sStats = {};
+
+#if defined(CONFIG_CHIP_WIFI)
+
+using namespace chip::DeviceLayer::NetworkCommissioning;
+
+constexpr size_t kMaxEntries = CONFIG_SOIL_WIFI_SCAN_CACHE_ENTRIES;
+constexpr uint64_t kTtlMs    = CONFIG_SOIL_WIFI_SCAN_CACHE_TTL_MS;
+
+// Owned by the CHIP thread.
+WiFiScanResponse sEntries[kMaxEntries];
+size_t sCount       = 0;
+uint64_t sScannedMs = 0; // 0 = nothing cached
+
+uint64_t NowMs()
+{
+    return chip::System::SystemClock().GetMonotonicMilliseconds64().count();
+}
+
+bool Fresh()
+{
+    return sScannedMs != 0 && NowMs() - sScannedMs < kTtlMs;
+}
+
+void Invalidate()
+{
+    sCount         = 0;
+    sScannedMs     = 0;
+    sStats.entries = 0;
+}
+
+void Insert(const WiFiScanResponse & result)
+{
+    if (sCount < kMaxEntries)
+    {
+        sEntries[sCount++] = result;
+        return;
+    }
+
+    // Full: a commissioner only offers the strongest networks to the user anyway.
+    WiFiScanResponse * weakest = std::min_element(sEntries, sEntries + sCount, [](const auto & a, const auto & b) {
+        return a.rssi < b.rssi;
+    });
+    sStats.dropped++;
+    if (result.rssi > weakest->rssi)
+    {
+        *weakest = result;
+    }
+}
+
+// Walks the cached table, optionally filtered to one SSID.
+class CachedIterator final : public WiFiScanResponseIterator
+{
+public:
+    void Reset(chip::ByteSpan ssid)
+    {
+        mSsidLen = std::min(ssid.size(), sizeof(mSsid));
+        memcpy(mSsid, ssid.data(), mSsidLen);
+        mIndex = 0;
+    }
+
+    size_t Count() override
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < sCount; ++i)
+        {
+            count += Matches(sEntries[i]) ? 1 : 0;
+        }
+        return count;
+    }
+
+    bool Next(WiFiScanResponse & item) override
+    {
+        while (mIndex < sCount)
+        {
+            const WiFiScanResponse & entry = sEntries[mIndex++];
+            if (Matches(entry))
+            {
+                item = entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Release() override { mIndex = 0; }
+
+    bool Empty() { return Count() == 0; }
+
+private:
+    bool Matches(const WiFiScanResponse & entry) const
+    {
+        return mSsidLen == 0 || (entry.ssidLen == mSsidLen && memcmp(entry.ssid, mSsid, mSsidLen) == 0);
+    }
+
+    uint8_t mSsid[chip::DeviceLayer::Internal::kMaxWiFiSSIDLength];
+    size_t mSsidLen = 0;
+    size_t mIndex   = 0;
+};
+
+CachedIterator sIterator;
+
+class CachingDriver final : public WiFiDriver, public WiFiDriver::ScanCallback
+{
+public:
+    // NetworkDriver
+    CHIP_ERROR Init(NetworkStatusChangeCallback * callback) override { return Inner().Init(callback); }
+    void Shutdown() override { Inner().Shutdown(); }
+    uint8_t GetMaxNetworks() override { return Inner().GetMaxNetworks(); }
+    NetworkIterator * GetNetworks() override { return Inner().GetNetworks(); }
+    uint8_t GetScanNetworkTimeoutSeconds() override { return Inner().GetScanNetworkTimeoutSeconds(); }
+    uint8_t GetConnectNetworkTimeoutSeconds() override { return Inner().GetConnectNetworkTimeoutSeconds(); }
+
+    CHIP_ERROR CommitConfiguration() override
+    {
+        ReturnErrorOnFailure(Inner().CommitConfiguration());
+        wifi_reconnect::OnConfigurationCommitted();
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR RevertConfiguration() override
+    {
+        wifi_reconnect::OnConfigurationReverted();
+        return Inner().RevertConfiguration();
+    }
+
+    Status RemoveNetwork(chip::ByteSpan networkId, chip::MutableCharSpan & outDebugText, uint8_t & outNetworkIndex) override
+    {
+        Status status = Inner().RemoveNetwork(networkId, outDebugText, outNetworkIndex);
+        if (status == Status::kSuccess)
+        {
+            wifi_reconnect::OnNetworkRemoved();
+        }
+        return status;
+    }
+
+    Status ReorderNetwork(chip::ByteSpan networkId, uint8_t index, chip::MutableCharSpan & outDebugText) override
+    {
+        return Inner().ReorderNetwork(networkId, index, outDebugText);
+    }
+
+    void ConnectNetwork(chip::ByteSpan networkId, ConnectCallback * callback) override
+    {
+        // Association changes what is in range from the device's point of view; rescan next time.
+        Invalidate();
+        Inner().ConnectNetwork(networkId, callback);
+    }
+
+    // WiFiDriver
+    Status AddOrUpdateNetwork(chip::ByteSpan ssid, chip::ByteSpan credentials, chip::MutableCharSpan & outDebugText,
+                              uint8_t & outNetworkIndex) override
+    {
+        Status status = Inner().AddOrUpdateNetwork(ssid, credentials, outDebugText, outNetworkIndex);
+        if (status == Status::kSuccess)
+        {
+            wifi_reconnect::OnNetworkStaged(ssid, credentials);
+        }
+        return status;
+    }
+
+    uint32_t GetSupportedWiFiBandsMask() const override { return Inner().GetSupportedWiFiBandsMask(); }
+
+    void ScanNetworks(chip::ByteSpan ssid, WiFiDriver::ScanCallback * callback) override
+    {
+        if (Fresh())
+        {
+            sIterator.Reset(ssid);
+            // Hidden networks only answer directed probes; an SSID we have not seen goes to the radio.
+            if (ssid.empty() || !sIterator.Empty())
+            {
+                sStats.hits++;
+                // Complete on the next event loop turn, like a radio scan would.
+                mClient = callback;
+                (void) chip::DeviceLayer::SystemLayer().ScheduleLambda([this] {
+                    WiFiDriver::ScanCallback * client = mClient;
+                    mClient                           = nullptr;
+                    if (client != nullptr)
+                    {
+                        client->OnFinished(Status::kSuccess, chip::CharSpan(), &sIterator);
+                    }
+                });
+                return;
+            }
+        }
+
+        sStats.misses++;
+        sStats.radioScans++;
+        mClient    = callback;
+        mBroadcast = ssid.empty();
+        Inner().ScanNetworks(ssid, this);
+    }
+
+    // WiFiDriver::ScanCallback, from the radio scan
+    void OnFinished(Status status, chip::CharSpan debugText, WiFiScanResponseIterator * networks) override
+    {
+        WiFiDriver::ScanCallback * client = mClient;
+        mClient                           = nullptr;
+
+        // A directed scan only sees one SSID; caching it would hide every other network.
+        const bool cache = (status == Status::kSuccess && mBroadcast && networks != nullptr);
+        if (cache)
+        {
+            Invalidate();
+        }
+        sIterator.Reset(chip::ByteSpan());
+
+        if (networks == nullptr || !cache)
+        {
+            if (client != nullptr)
+            {
+                client->OnFinished(status, debugText, networks);
+            }
+            return;
+        }
+
+        WiFiScanResponse result;
+        while (networks->Next(result))
+        {
+            Insert(result);
+        }
+        // Frees the driver's result list (grown with realloc per result) right away.
+        networks->Release();
+        sScannedMs     = NowMs();
+        sStats.entries = static_cast<uint8_t>(sCount);
+
+        if (client != nullptr)
+        {
+            client->OnFinished(status, debugText, &sIterator);
+        }
+    }
+
+private:
+    static NrfWiFiDriver & Inner() { return NrfWiFiDriver::Instance(); }
+
+    WiFiDriver::ScanCallback * mClient = nullptr;
+    bool mBroadcast                    = false;
+};
+
+CachingDriver sDriver;
+
+#endif // CONFIG_CHIP_WIFI
+
+} // namespace
+
+#if defined(CONFIG_CHIP_WIFI)
+chip::DeviceLayer::NetworkCommissioning::WiFiDriver & Driver()
+{
+    return sDriver;
+}
+#endif
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+#if defined(CONFIG_CHIP_WIFI)
+    if (event->Type == chip::DeviceLayer::DeviceEventType::kCommissioningWindowClosed && sCount != 0)
+    {
+        ChipLogProgress(DeviceLayer, "Scan cache: %u hits, %u radio scans this window",
+                        static_cast<unsigned>(sStats.hits), static_cast<unsigned>(sStats.radioScans));
+        Invalidate();
+    }
+#endif
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+} // namespace wifi_scan_cache
+} // namespace connectivity
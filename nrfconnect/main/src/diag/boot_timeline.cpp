@@ -0,0 +1,198 @@
+#include "diag/boot_timeline.h"
+
+#include "cfg/settings_writeback.h"
+#include "matter/vendor_diagnostics.h"
+
+#include <lib/core/ErrorStr.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/util.h>
+
+#include <cstring>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace diag
+{
+namespace boot_timeline
+{
+
+namespace
+{
+
+constexpr char kSettingsKey[]       = "soil/boot";
+constexpr uint8_t kPersistedVersion = 2;
+constexpr uint8_t kSnapshotVersion  = 2;
+
+constexpr const char * kPhaseNames[kPhaseCount] = {
+    "pre-main",    "settings init", "chip stack",    "app task",       "settings load",  "wifi init",
+    "server init", "registrations", "access control", "cluster init", "onboarding log", "event loop",
+    "advertising",
+};
+
+struct PersistedTimeline
+{
+    uint8_t version;
+    uint8_t phaseCount;
+    uint16_t reserved;
+    uint32_t startUs[kPhaseCount];
+    uint32_t endUs[kPhaseCount];
+};
+
+uint32_t sStartCycles[kPhaseCount];
+uint32_t sEndCycles[kPhaseCount];
+PersistedTimeline sPrevious = {};
+bool sHasPrevious           = false;
+bool sComplete              = false;
+
+int LoadPersisted(const char * key, size_t len, settings_read_cb readCb, void * cbArg, void * param)
+{
+    auto * record = static_cast<PersistedTimeline *>(param);
+    if (key != nullptr || len != sizeof(*record))
+    {
+        return 0;
+    }
+
+    if (readCb(cbArg, record, sizeof(*record)) != static_cast<ssize_t>(sizeof(*record)))
+    {
+        memset(record, 0, sizeof(*record));
+    }
+    return 0;
+}
+
+} // namespace
+
+void Begin()
+{
+    memset(sStartCycles, 0, sizeof(sStartCycles));
+    memset(sEndCycles, 0, sizeof(sEndCycles));
+    sComplete = false;
+    Mark(Phase::PreMain);
+
+    CHIP_ERROR err = matter::vendor_diagnostics::Register(matter::vendor_diagnostics::kBootTimeline, Snapshot);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_WRN("Boot timeline attribute not registered: %s", chip::ErrorStr(err));
+    }
+}
+
+void Start(Phase phase)
+{
+    const uint8_t index = static_cast<uint8_t>(phase);
+    if (index < kPhaseCount)
+    {
+        sStartCycles[index] = k_cycle_get_32();
+    }
+}
+
+void Mark(Phase phase)
+{
+    const uint8_t index = static_cast<uint8_t>(phase);
+    if (index < kPhaseCount)
+    {
+        // The kernel cycle counter starts at zero on reset, so marks are absolute boot offsets.
+        sEndCycles[index] = k_cycle_get_32();
+    }
+}
+
+void Complete()
+{
+    if (sComplete)
+    {
+        return;
+    }
+    sComplete = true;
+
+    uint32_t lastEndUs = 0;
+    for (uint8_t i = 0; i < kPhaseCount; ++i)
+    {
+        const uint32_t startUs = GetPhaseStartUs(static_cast<Phase>(i));
+        const uint32_t endUs   = GetPhaseEndUs(static_cast<Phase>(i));
+        if (endUs == 0)
+        {
+            LOG_INF("Boot %-15s       -", kPhaseNames[i]);
+            continue;
+        }
+        LOG_INF("Boot %-15s %7u us (%u..%u ms)", kPhaseNames[i], endUs - startUs, startUs / 1000, endUs / 1000);
+        lastEndUs = MAX(lastEndUs, endUs);
+    }
+
+    // Keep the previous boot's record before overwriting it with this one.
+    PersistedTimeline previous = {};
+    (void) settings_load_subtree_direct(kSettingsKey, LoadPersisted, &previous);
+    sHasPrevious = (previous.version == kPersistedVersion && previous.phaseCount == kPhaseCount);
+    if (sHasPrevious)
+    {
+        sPrevious = previous;
+        LOG_INF("Boot total %u ms (previous boot %u ms)", lastEndUs / 1000, sPrevious.endUs[kPhaseCount - 1] / 1000);
+    }
+
+    PersistedTimeline record = {};
+    record.version           = kPersistedVersion;
+    record.phaseCount        = kPhaseCount;
+    for (uint8_t i = 0; i < kPhaseCount; ++i)
+    {
+        record.startUs[i] = GetPhaseStartUs(static_cast<Phase>(i));
+        record.endUs[i]   = GetPhaseEndUs(static_cast<Phase>(i));
+    }
+
+    int rc = cfg::settings_writeback::Write(kSettingsKey, &record, sizeof(record));
+    if (rc != 0)
+    {
+        LOG_WRN("Failed to persist boot timeline: %d", rc);
+    }
+}
+
+uint32_t GetPhaseStartUs(Phase phase)
+{
+    const uint8_t index = static_cast<uint8_t>(phase);
+    if (index >= kPhaseCount || sEndCycles[index] == 0)
+    {
+        return 0;
+    }
+    if (sStartCycles[index] != 0)
+    {
+        return k_cyc_to_us_floor32(sStartCycles[index]);
+    }
+
+    // Unstarted phases begin where the closest preceding phase ended.
+    for (uint8_t i = index; i > 0; --i)
+    {
+        if (sEndCycles[i - 1] != 0)
+        {
+            return k_cyc_to_us_floor32(sEndCycles[i - 1]);
+        }
+    }
+    return 0;
+}
+
+uint32_t GetPhaseEndUs(Phase phase)
+{
+    const uint8_t index = static_cast<uint8_t>(phase);
+    return (index < kPhaseCount) ? k_cyc_to_us_floor32(sEndCycles[index]) : 0;
+}
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out)
+{
+    chip::Encoding::LittleEndian::BufferWriter writer(out.data(), out.size());
+    writer.Put8(kSnapshotVersion).Put8(kPhaseCount).Put8(sComplete ? 1 : 0).Put8(sHasPrevious ? 1 : 0);
+    for (uint8_t i = 0; i < kPhaseCount; ++i)
+    {
+        writer.Put32(GetPhaseStartUs(static_cast<Phase>(i))).Put32(GetPhaseEndUs(static_cast<Phase>(i)));
+    }
+    for (uint8_t i = 0; i < kPhaseCount; ++i)
+    {
+        writer.Put32(sHasPrevious ? sPrevious.startUs[i] : 0).Put32(sHasPrevious ? sPrevious.endUs[i] : 0);
+    }
+
+    size_t written = 0;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+    out.reduce_size(written);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace boot_timeline
+} // namespace diag
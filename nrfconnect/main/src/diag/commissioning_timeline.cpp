@@ -0,0 +1,170 @@
+#include "diag/commissioning_timeline.h"
+
+#include "matter/vendor_diagnostics.h"
+
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app-common/zap-generated/ids/Commands.h>
+#include <lib/core/ErrorStr.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <cstring>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace diag
+{
+namespace commissioning_timeline
+{
+
+namespace
+{
+
+namespace OpCreds = chip::app::Clusters::OperationalCredentials;
+
+constexpr uint8_t kSnapshotVersion = 1;
+
+enum class Result : uint8_t
+{
+    None = 0,
+    Running,
+    Complete,
+    FailSafeExpired,
+};
+
+// Owned by the CHIP thread.
+uint32_t sStartMs            = 0;
+uint32_t sEndMs[kPhaseCount] = {};
+Result sResult               = Result::None;
+uint32_t sAttempts           = 0;
+
+void Restart()
+{
+    sStartMs = k_uptime_get_32();
+    memset(sEndMs, 0, sizeof(sEndMs));
+    sResult = Result::Running;
+    sAttempts++;
+}
+
+void Mark(Phase phase)
+{
+    if (sResult == Result::Running)
+    {
+        sEndMs[static_cast<uint8_t>(phase)] = k_uptime_get_32();
+    }
+}
+
+uint32_t PhaseStartMs(uint8_t index)
+{
+    // A phase begins where the closest preceding phase ended.
+    for (uint8_t i = index; i > 0; --i)
+    {
+        if (sEndMs[i - 1] != 0)
+        {
+            return sEndMs[i - 1];
+        }
+    }
+    return sStartMs;
+}
+
+void Finish(Result result)
+{
+    if (sResult != Result::Running)
+    {
+        return;
+    }
+    sResult = result;
+
+    LOG_INF("Commissioning %s: pase %u ms, csr %u ms, addnoc %u ms, network %u ms, total %u ms",
+            result == Result::Complete ? "complete" : "failed", GetPhaseMs(Phase::Pase), GetPhaseMs(Phase::Csr),
+            GetPhaseMs(Phase::AddNoc), GetPhaseMs(Phase::NetworkSetup), k_uptime_get_32() - sStartMs);
+}
+
+} // namespace
+
+void Init()
+{
+    CHIP_ERROR err =
+        matter::vendor_diagnostics::Register(matter::vendor_diagnostics::kCommissioningTimeline, Snapshot);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_WRN("Commissioning timeline attribute not registered: %s", chip::ErrorStr(err));
+    }
+}
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+    using namespace chip::DeviceLayer;
+
+    switch (event->Type)
+    {
+    case DeviceEventType::kCHIPoBLEConnectionEstablished:
+        Restart();
+        break;
+    case DeviceEventType::kCommissioningSessionStarted:
+        // On-network commissioning has no BLE connection to start from, and a commissioner that
+        // retries PASE on the same connection starts over.
+        if (sResult != Result::Running || sEndMs[static_cast<uint8_t>(Phase::Pase)] != 0)
+        {
+            Restart();
+        }
+        Mark(Phase::Pase);
+        break;
+    case DeviceEventType::kCommissioningComplete:
+        Mark(Phase::NetworkSetup);
+        Finish(Result::Complete);
+        break;
+    case DeviceEventType::kFailSafeTimerExpired:
+        Finish(Result::FailSafeExpired);
+        break;
+    default:
+        break;
+    }
+}
+
+void OnCommandHandled(const chip::app::ConcreteCommandPath & path)
+{
+    if (path.mClusterId != OpCreds::Id)
+    {
+        return;
+    }
+
+    if (path.mCommandId == OpCreds::Commands::CSRRequest::Id)
+    {
+        Mark(Phase::Csr);
+    }
+    else if (path.mCommandId == OpCreds::Commands::AddNOC::Id)
+    {
+        Mark(Phase::AddNoc);
+    }
+}
+
+uint32_t GetPhaseMs(Phase phase)
+{
+    const uint8_t index = static_cast<uint8_t>(phase);
+    if (index >= kPhaseCount || sEndMs[index] == 0)
+    {
+        return 0;
+    }
+    return sEndMs[index] - PhaseStartMs(index);
+}
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out)
+{
+    chip::Encoding::LittleEndian::BufferWriter writer(out.data(), out.size());
+    writer.Put8(kSnapshotVersion).Put8(kPhaseCount).Put8(static_cast<uint8_t>(sResult)).Put8(0).Put32(sAttempts);
+    for (uint8_t i = 0; i < kPhaseCount; ++i)
+    {
+        writer.Put32(GetPhaseMs(static_cast<Phase>(i)));
+    }
+
+    size_t written = 0;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+    out.reduce_size(written);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace commissioning_timeline
+} // namespace diag
@@ -0,0 +1,441 @@
+#include "diag/heap_stats.h"
+
+#include "matter/vendor_diagnostics.h"
+
+#include <lib/core/ErrorStr.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/heap_listener.h>
+#include <zephyr/sys/sys_heap.h>
+
+#if defined(CONFIG_CHIP_MALLOC_SYS_HEAP)
+#include <platform/Zephyr/SysHeapMalloc.h>
+#endif
+
+#include <algorithm>
+#include <initializer_list>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+#ifndef CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S
+#define CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S 60
+#endif
+
+#ifndef CONFIG_SOIL_HEAP_RING_SIZE
+#define CONFIG_SOIL_HEAP_RING_SIZE 16
+#endif
+
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS) && defined(CONFIG_HEAP_MEM_POOL_SIZE) && (CONFIG_HEAP_MEM_POOL_SIZE > 0)
+#define SOIL_KERNEL_HEAP_STATS 1
+// Defined by the kernel for k_malloc; not exposed in a public header.
+extern "C" struct k_heap _system_heap;
+// sys_heap chunk layout; CMakeLists.txt puts ZEPHYR_BASE/lib on the include path for it.
+extern "C" {
+#include <heap/heap.h>
+}
+#endif
+
+namespace diag
+{
+namespace heap_stats
+{
+
+namespace
+{
+
+constexpr uint8_t kSnapshotVersion   = 1;
+constexpr uint32_t kSampleIntervalMs = CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S * 1000U;
+constexpr size_t kRingSize           = CONFIG_SOIL_HEAP_RING_SIZE;
+constexpr size_t kMaxSnapshotSamples = 8;  // keeps the attribute within kMaxValueSize
+constexpr size_t kMaxTags            = 16; // the last one collects overflow call sites
+
+// Owned by the CHIP thread.
+Sample sRing[kRingSize];
+size_t sRingNext      = 0;
+size_t sRingCount     = 0;
+uint32_t sChipPeak    = 0;
+uint32_t sChipLargest = 0; // from the last on-demand probe, 0 until then
+
+// Updated from the heap listener and the k_malloc wrappers, in the allocating context.
+k_spinlock sLock;
+uint32_t sKernelAllocs = 0;
+uint32_t sKernelFrees  = 0;
+
+#if defined(CONFIG_SOIL_HEAP_TAGS)
+struct Tag
+{
+    const void * site;
+    uint32_t allocs;
+    uint32_t failures;
+    uint32_t bytes;
+    uint32_t largest;
+};
+
+Tag sTags[kMaxTags];
+
+void RecordTag(const void * site, size_t bytes, bool ok)
+{
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    Tag * tag            = &sTags[kMaxTags - 1];
+    for (size_t i = 0; i + 1 < kMaxTags; ++i)
+    {
+        if (sTags[i].site == site || sTags[i].site == nullptr)
+        {
+            tag       = &sTags[i];
+            tag->site = site;
+            break;
+        }
+    }
+    tag->allocs++;
+    tag->failures += ok ? 0 : 1;
+    tag->bytes += static_cast<uint32_t>(bytes);
+    tag->largest = std::max(tag->largest, static_cast<uint32_t>(bytes));
+    k_spin_unlock(&sLock, key);
+}
+#endif
+
+#if defined(SOIL_KERNEL_HEAP_STATS) && defined(CONFIG_SYS_HEAP_LISTENER)
+heap_listener sAllocListener;
+heap_listener sFreeListener;
+
+void OnKernelAlloc(uintptr_t, void *, size_t)
+{
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    sKernelAllocs++;
+    k_spin_unlock(&sLock, key);
+}
+
+void OnKernelFree(uintptr_t, void *, size_t)
+{
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    sKernelFrees++;
+    k_spin_unlock(&sLock, key);
+}
+#endif
+
+#if defined(SOIL_KERNEL_HEAP_STATS)
+// Largest single allocation the kernel heap can serve, from a walk of its chunk list under the
+// heap lock. Nothing is allocated, so other threads' allocations are never starved by the
+// measurement; the walk is a few hundred chunk header reads.
+uint32_t KernelLargestFree()
+{
+    z_heap * h     = _system_heap.heap.heap;
+    size_t largest = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&_system_heap.lock);
+    for (chunkid_t c = right_chunk(h, 0); c != h->end_chunk; c = right_chunk(h, c))
+    {
+        if (!chunk_used(h, c))
+        {
+            largest = std::max(largest, chunksz_to_bytes(h, chunk_size(h, c)));
+        }
+    }
+    k_spin_unlock(&_system_heap.lock, key);
+
+    return (largest > chunk_header_bytes(h)) ? static_cast<uint32_t>(largest - chunk_header_bytes(h)) : 0;
+}
+#endif
+
+#if defined(CONFIG_SOIL_HEAP_PROBE_CHIP) && defined(CONFIG_CHIP_MALLOC_SYS_HEAP)
+// Largest single allocation that currently succeeds, by binary search up to `freeBytes`. The
+// CHIP heap is private to the SDK and cannot be walked; while a probe block is held, other
+// allocations from that heap can fail, so this only runs on request in debug builds.
+template <typename Alloc, typename Release>
+uint32_t ProbeLargest(uint32_t freeBytes, Alloc alloc, Release release)
+{
+    uint32_t low  = 0;
+    uint32_t high = freeBytes;
+    while (low < high)
+    {
+        const uint32_t mid = low + (high - low + 1) / 2;
+        void * block       = alloc(mid);
+        if (block != nullptr)
+        {
+            release(block);
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+#endif
+
+HeapInfo KernelInfo()
+{
+    HeapInfo info = {};
+#if defined(SOIL_KERNEL_HEAP_STATS)
+    sys_memory_stats stats;
+    if (sys_heap_runtime_stats_get(&_system_heap.heap, &stats) != 0)
+    {
+        return info;
+    }
+
+    info.sizeBytes        = static_cast<uint32_t>(stats.free_bytes + stats.allocated_bytes);
+    info.usedBytes        = static_cast<uint32_t>(stats.allocated_bytes);
+    info.peakBytes        = static_cast<uint32_t>(stats.max_allocated_bytes);
+    info.largestFreeBytes = KernelLargestFree();
+#endif
+    return info;
+}
+
+HeapInfo ChipInfo(bool probe)
+{
+    HeapInfo info = {};
+#if defined(CONFIG_CHIP_MALLOC_SYS_HEAP)
+    chip::DeviceLayer::Malloc::Stats stats;
+    if (chip::DeviceLayer::Malloc::GetStats(stats) != CHIP_NO_ERROR)
+    {
+        return info;
+    }
+    sChipPeak = std::max(sChipPeak, static_cast<uint32_t>(stats.maxUsed));
+
+#if defined(CONFIG_SOIL_HEAP_PROBE_CHIP)
+    if (probe)
+    {
+        sChipLargest = ProbeLargest(
+            static_cast<uint32_t>(stats.free), [](size_t size) { return chip::DeviceLayer::Malloc::Malloc(size); },
+            [](void * block) { chip::DeviceLayer::Malloc::Free(block); });
+        // The probes pushed the heap's own high-water mark up; ours keeps the real one.
+        chip::DeviceLayer::Malloc::ResetMaxStats();
+    }
+#else
+    (void) probe;
+#endif
+
+    info.sizeBytes        = static_cast<uint32_t>(stats.free + stats.used);
+    info.usedBytes        = static_cast<uint32_t>(stats.used);
+    info.peakBytes        = sChipPeak;
+    info.largestFreeBytes = sChipLargest;
+#else
+    (void) probe;
+#endif
+    return info;
+}
+
+void LogHeap(const char * name, const HeapInfo & info)
+{
+    if (info.sizeBytes == 0)
+    {
+        return;
+    }
+    if (info.largestFreeBytes == 0)
+    {
+        // Not measured: the CHIP heap without CONFIG_SOIL_HEAP_PROBE_CHIP or before its first probe.
+        LOG_INF("Heap %-6s used %u/%u B, peak %u B, largest free unknown", name, info.usedBytes, info.sizeBytes,
+                info.peakBytes);
+        return;
+    }
+    const uint32_t freeBytes  = info.sizeBytes - info.usedBytes;
+    const uint32_t fragmented = (freeBytes == 0) ? 0 : 100 - (info.largestFreeBytes * 100) / freeBytes;
+    LOG_INF("Heap %-6s used %u/%u B, peak %u B, largest free %u B (%u%% fragmented)", name, info.usedBytes,
+            info.sizeBytes, info.peakBytes, info.largestFreeBytes, fragmented);
+}
+
+void SampleTimer(chip::System::Layer *, void *)
+{
+    TakeSample();
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(kSampleIntervalMs), SampleTimer,
+                                                       nullptr);
+}
+
+} // namespace
+
+void Init()
+{
+    if (!IS_ENABLED(CONFIG_SOIL_HEAP_STATS))
+    {
+        return;
+    }
+
+#if defined(SOIL_KERNEL_HEAP_STATS) && defined(CONFIG_SYS_HEAP_LISTENER)
+    sAllocListener.heap_id  = HEAP_ID_FROM_POINTER(&_system_heap.heap);
+    sAllocListener.event    = HEAP_ALLOC;
+    sAllocListener.alloc_cb = OnKernelAlloc;
+    heap_listener_register(&sAllocListener);
+
+    sFreeListener.heap_id = HEAP_ID_FROM_POINTER(&_system_heap.heap);
+    sFreeListener.event   = HEAP_FREE;
+    sFreeListener.free_cb = OnKernelFree;
+    heap_listener_register(&sFreeListener);
+#endif
+
+    CHIP_ERROR err = matter::vendor_diagnostics::Register(matter::vendor_diagnostics::kHeapStats, Snapshot);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_WRN("Heap stats attribute not registered: %s", chip::ErrorStr(err));
+    }
+
+    (void) chip::DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) { SampleTimer(nullptr, nullptr); });
+}
+
+void AppEventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+    if (!IS_ENABLED(CONFIG_SOIL_HEAP_STATS))
+    {
+        return;
+    }
+
+    switch (event->Type)
+    {
+    case chip::DeviceLayer::DeviceEventType::kCommissioningComplete:
+    case chip::DeviceLayer::DeviceEventType::kFailSafeTimerExpired:
+        // Commissioning is the heap's worst case; record where it left both heaps.
+        TakeSample();
+        Dump();
+        break;
+    default:
+        break;
+    }
+}
+
+Stats GetStats()
+{
+    Stats stats  = {};
+    stats.kernel = KernelInfo();
+    stats.chip   = ChipInfo(false);
+
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    stats.kernelAllocs   = sKernelAllocs;
+    stats.kernelFrees    = sKernelFrees;
+    k_spin_unlock(&sLock, key);
+    return stats;
+}
+
+void TakeSample()
+{
+    const HeapInfo kernel = KernelInfo();
+    const HeapInfo chip   = ChipInfo(false);
+
+    Sample & sample               = sRing[sRingNext];
+    sample.uptimeS                = static_cast<uint32_t>(k_uptime_get() / 1000);
+    sample.kernelUsedBytes        = kernel.usedBytes;
+    sample.kernelLargestFreeBytes = kernel.largestFreeBytes;
+    sample.chipUsedBytes          = chip.usedBytes;
+    sample.chipLargestFreeBytes   = chip.largestFreeBytes;
+
+    sRingNext  = (sRingNext + 1) % kRingSize;
+    sRingCount = std::min(sRingCount + 1, kRingSize);
+}
+
+void Dump()
+{
+    const Stats stats = GetStats();
+    LogHeap("kernel", stats.kernel);
+    LOG_INF("Heap kernel allocs %u, frees %u", stats.kernelAllocs, stats.kernelFrees);
+    LogHeap("chip", stats.chip);
+
+    for (size_t i = 0; i < sRingCount; ++i)
+    {
+        const Sample & sample = sRing[(sRingNext + kRingSize - sRingCount + i) % kRingSize];
+        LOG_INF("Heap @%us kernel %u B used, %u B largest; chip %u B used, %u B largest", sample.uptimeS,
+                sample.kernelUsedBytes, sample.kernelLargestFreeBytes, sample.chipUsedBytes, sample.chipLargestFreeBytes);
+    }
+
+#if defined(CONFIG_SOIL_HEAP_TAGS)
+    Tag tags[kMaxTags];
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    std::copy(sTags, sTags + kMaxTags, tags);
+    k_spin_unlock(&sLock, key);
+
+    // Resolve the call sites with addr2line against zephyr.elf.
+    for (size_t i = 0; i < kMaxTags; ++i)
+    {
+        if (tags[i].allocs == 0)
+        {
+            continue;
+        }
+        if (i + 1 < kMaxTags)
+        {
+            LOG_INF("Heap site %p: %u allocs (%u failed), %u B, largest %u B", tags[i].site, tags[i].allocs,
+                    tags[i].failures, tags[i].bytes, tags[i].largest);
+        }
+        else
+        {
+            LOG_INF("Heap site other: %u allocs (%u failed), %u B, largest %u B", tags[i].allocs, tags[i].failures,
+                    tags[i].bytes, tags[i].largest);
+        }
+    }
+#endif
+}
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out)
+{
+    // An attribute read is the on-demand trigger for the CHIP heap probe (debug builds only).
+    Stats stats          = GetStats();
+    stats.chip           = ChipInfo(true);
+    const size_t samples = std::min(sRingCount, kMaxSnapshotSamples);
+
+    chip::Encoding::LittleEndian::BufferWriter writer(out.data(), out.size());
+    writer.Put8(kSnapshotVersion).Put8(static_cast<uint8_t>(samples)).Put16(0);
+    for (const HeapInfo * info : { &stats.kernel, &stats.chip })
+    {
+        writer.Put32(info->sizeBytes).Put32(info->usedBytes).Put32(info->peakBytes).Put32(info->largestFreeBytes);
+    }
+    writer.Put32(stats.kernelAllocs).Put32(stats.kernelFrees);
+
+    // Newest first.
+    for (size_t i = 0; i < samples; ++i)
+    {
+        const Sample & sample = sRing[(sRingNext + kRingSize - 1 - i) % kRingSize];
+        writer.Put32(sample.uptimeS)
+            .Put32(sample.kernelUsedBytes)
+            .Put32(sample.kernelLargestFreeBytes)
+            .Put32(sample.chipUsedBytes)
+            .Put32(sample.chipLargestFreeBytes);
+    }
+
+    size_t written = 0;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+    out.reduce_size(written);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace heap_stats
+} // namespace diag
+
+#if defined(CONFIG_SOIL_HEAP_TAGS)
+// k_malloc and k_calloc are routed here with -Wl,--wrap (see CMakeLists.txt), so each kernel heap
+// allocation is tagged with the address it was called from.
+extern "C" void * __real_k_malloc(size_t size);
+extern "C" void * __real_k_calloc(size_t nmemb, size_t size);
+
+extern "C" void * __wrap_k_malloc(size_t size)
+{
+    void * block = __real_k_malloc(size);
+    diag::heap_stats::RecordTag(__builtin_return_address(0), size, block != nullptr);
+    return block;
+}
+
+extern "C" void * __wrap_k_calloc(size_t nmemb, size_t size)
+{
+    void * block = __real_k_calloc(nmemb, size);
+    diag::heap_stats::RecordTag(__builtin_return_address(0), nmemb * size, block != nullptr);
+    return block;
+}
+
+#if !defined(CONFIG_CHIP_MALLOC_SYS_HEAP_OVERRIDE)
+// Without the CHIP heap's own malloc override, malloc/calloc are wrapped too. CHIP allocates
+// through chip::Platform::MemoryAlloc, so its allocations share that one call site.
+extern "C" void * __real_malloc(size_t size);
+extern "C" void * __real_calloc(size_t nmemb, size_t size);
+
+extern "C" void * __wrap_malloc(size_t size)
+{
+    void * block = __real_malloc(size);
+    diag::heap_stats::RecordTag(__builtin_return_address(0), size, block != nullptr);
+    return block;
+}
+
+extern "C" void * __wrap_calloc(size_t nmemb, size_t size)
+{
+    void * block = __real_calloc(nmemb, size);
+    diag::heap_stats::RecordTag(__builtin_return_address(0), nmemb * size, block != nullptr);
+    return block;
+}
+#endif
+#endif
@@ -0,0 +1,319 @@
+#include "diag/nvs_telemetry.h"
+
+#include "cfg/settings_writeback.h"
+#include "matter/vendor_diagnostics.h"
+
+#include <lib/core/ErrorStr.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <zephyr/fs/nvs.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include <algorithm>
+#include <cstring>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace diag
+{
+namespace nvs_telemetry
+{
+
+namespace
+{
+
+constexpr uint16_t kMaxSectors = CONFIG_SETTINGS_NVS_SECTOR_COUNT;
+// NVS addresses carry the sector number in the upper half-word (ADDR_SECT_SHIFT in nvs_priv.h).
+constexpr uint32_t kAddrSectShift = 16;
+
+constexpr char kSettingsKey[]       = "soil/nvs";
+constexpr uint8_t kPersistedVersion = 1;
+constexpr uint8_t kSnapshotVersion  = 1;
+
+struct PersistedWear
+{
+    uint8_t version;
+    uint8_t sectorCount;
+    uint16_t reserved;
+    uint32_t gcCycles;
+    uint32_t eraseCounts[kMaxSectors];
+};
+
+nvs_fs * sFs = nullptr;
+k_spinlock sLock;
+Stats sStats = {};
+uint32_t sEraseCounts[kMaxSectors];
+uint16_t sLastSector = 0;
+bool sPersisting     = false;
+
+// ate_wra moves under nvs_lock while another thread writes; never call with sLock held.
+uint16_t CurrentSector()
+{
+    k_mutex_lock(&sFs->nvs_lock, K_FOREVER);
+    const uint32_t ateWra = sFs->ate_wra;
+    k_mutex_unlock(&sFs->nvs_lock);
+    return static_cast<uint16_t>(ateWra >> kAddrSectShift);
+}
+
+// Accounts for every sector advance since the last observation. Returns the number of GC cycles seen.
+uint16_t ObserveLocked(uint16_t sector)
+{
+    const uint16_t count    = sStats.sectorCount;
+    const uint16_t advanced = static_cast<uint16_t>((sector + count - sLastSector) % count);
+
+    for (uint16_t i = 1; i <= advanced; ++i)
+    {
+        // Opening sector N garbage-collects and erases sector N+1, the oldest one.
+        sEraseCounts[(sLastSector + i + 1) % count]++;
+    }
+    sStats.gcCycles += advanced;
+    sStats.activeSector = sector;
+    sLastSector         = sector;
+    return advanced;
+}
+
+uint32_t FreeBytes()
+{
+    const ssize_t free = nvs_calc_free_space(sFs);
+    return (free < 0) ? 0 : static_cast<uint32_t>(free);
+}
+
+void UpdateFreeSpace()
+{
+    const uint32_t free = FreeBytes();
+
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    sStats.freeBytes     = free;
+    sStats.minFreeBytes  = std::min(sStats.minFreeBytes, free);
+    k_spin_unlock(&sLock, key);
+}
+
+void Persist()
+{
+    // The record itself goes through NVS and may trigger the next GC; don't recurse on it.
+    if (sPersisting)
+    {
+        return;
+    }
+    sPersisting = true;
+
+    PersistedWear record = {};
+    record.version       = kPersistedVersion;
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    record.sectorCount   = static_cast<uint8_t>(sStats.sectorCount);
+    record.gcCycles      = sStats.gcCycles;
+    memcpy(record.eraseCounts, sEraseCounts, sizeof(record.eraseCounts));
+    k_spin_unlock(&sLock, key);
+
+    int rc = cfg::settings_writeback::Write(kSettingsKey, &record, sizeof(record));
+    if (rc != 0)
+    {
+        LOG_WRN("Failed to persist NVS wear counters: %d", rc);
+    }
+    sPersisting = false;
+}
+
+int LoadPersisted(const char * key, size_t len, settings_read_cb readCb, void * cbArg, void * param)
+{
+    auto * record = static_cast<PersistedWear *>(param);
+    if (key != nullptr || len != sizeof(*record))
+    {
+        return 0;
+    }
+
+    if (readCb(cbArg, record, sizeof(*record)) != static_cast<ssize_t>(sizeof(*record)))
+    {
+        memset(record, 0, sizeof(*record));
+    }
+    return 0;
+}
+
+void Restore()
+{
+    PersistedWear record = {};
+    (void) settings_load_subtree_direct(kSettingsKey, LoadPersisted, &record);
+
+    // A resized partition invalidates the per-sector history.
+    if (record.version != kPersistedVersion || record.sectorCount != sStats.sectorCount)
+    {
+        return;
+    }
+    sStats.gcCycles = record.gcCycles;
+    memcpy(sEraseCounts, record.eraseCounts, sizeof(sEraseCounts));
+}
+
+void OnGarbageCollected(uint16_t cycles, uint32_t durationUs)
+{
+    UpdateFreeSpace();
+    const Stats stats = GetStats();
+
+    if (durationUs != 0)
+    {
+        LOG_INF("NVS GC x%u in %u us, sector %u active, %u B free", cycles, durationUs, stats.activeSector, stats.freeBytes);
+    }
+    else
+    {
+        LOG_INF("NVS GC x%u (untimed), sector %u active, %u B free", cycles, stats.activeSector, stats.freeBytes);
+    }
+    Persist();
+}
+
+} // namespace
+
+void Init()
+{
+    if (sFs != nullptr)
+    {
+        return;
+    }
+
+    void * storage = nullptr;
+    int rc         = settings_storage_get(&storage);
+    if (rc != 0 || storage == nullptr)
+    {
+        LOG_WRN("NVS telemetry unavailable: %d", rc);
+        return;
+    }
+
+    sFs                 = static_cast<nvs_fs *>(storage);
+    sStats              = {};
+    sStats.sectorCount  = std::min<uint16_t>(sFs->sector_count, kMaxSectors);
+    sStats.minFreeBytes = UINT32_MAX;
+    memset(sEraseCounts, 0, sizeof(sEraseCounts));
+    Restore();
+
+    sLastSector         = CurrentSector();
+    sStats.activeSector = sLastSector;
+    UpdateFreeSpace();
+
+    CHIP_ERROR err = matter::vendor_diagnostics::Register(matter::vendor_diagnostics::kNvsTelemetry, Snapshot);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_WRN("NVS telemetry attribute not registered: %s", chip::ErrorStr(err));
+    }
+
+    LogStats();
+}
+
+WriteProbe BeginWrite()
+{
+    if (sFs == nullptr)
+    {
+        return WriteProbe{};
+    }
+
+    // Catch up on advances made by writers outside the probes, so they are not charged to this write.
+    const uint16_t sector  = CurrentSector();
+    k_spinlock_key_t key   = k_spin_lock(&sLock);
+    const uint16_t untimed = ObserveLocked(sector);
+    sStats.untimedGcCycles += untimed;
+    const WriteProbe probe{ k_cycle_get_32(), sLastSector };
+    k_spin_unlock(&sLock, key);
+
+    if (untimed != 0)
+    {
+        OnGarbageCollected(untimed, 0);
+    }
+    return probe;
+}
+
+void EndWrite(const WriteProbe & probe)
+{
+    if (sFs == nullptr)
+    {
+        return;
+    }
+
+    const uint16_t sector = CurrentSector();
+    if (sector == probe.sector)
+    {
+        return;
+    }
+
+    // The write itself is negligible next to compacting and erasing a sector.
+    const uint32_t durationUs = k_cyc_to_us_ceil32(k_cycle_get_32() - probe.startCycles);
+
+    k_spinlock_key_t key  = k_spin_lock(&sLock);
+    const uint16_t cycles = ObserveLocked(sector);
+    if (cycles != 0)
+    {
+        sStats.lastGcUs = durationUs;
+        sStats.maxGcUs  = std::max(sStats.maxGcUs, durationUs);
+        sStats.totalGcUs += durationUs;
+    }
+    k_spin_unlock(&sLock, key);
+
+    if (cycles != 0)
+    {
+        OnGarbageCollected(cycles, durationUs);
+    }
+}
+
+Stats GetStats()
+{
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    const Stats stats    = sStats;
+    k_spin_unlock(&sLock, key);
+    return stats;
+}
+
+uint32_t GetEraseCount(uint16_t sector)
+{
+    k_spinlock_key_t key = k_spin_lock(&sLock);
+    const uint32_t count = (sector < sStats.sectorCount) ? sEraseCounts[sector] : 0;
+    k_spin_unlock(&sLock, key);
+    return count;
+}
+
+void LogStats()
+{
+    if (sFs == nullptr)
+    {
+        return;
+    }
+
+    UpdateFreeSpace();
+    const Stats stats = GetStats();
+
+    LOG_INF("NVS: %u B free (min %u), sector %u/%u, GC %u lifetime (%u untimed), last %u us, max %u us, total %u us",
+            stats.freeBytes, stats.minFreeBytes, stats.activeSector, stats.sectorCount, stats.gcCycles, stats.untimedGcCycles,
+            stats.lastGcUs, stats.maxGcUs, stats.totalGcUs);
+    for (uint16_t i = 0; i < stats.sectorCount; ++i)
+    {
+        LOG_INF("  NVS sector %u: %u erases", i, GetEraseCount(i));
+    }
+}
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out)
+{
+    VerifyOrReturnError(sFs != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    UpdateFreeSpace();
+    const Stats stats = GetStats();
+
+    chip::Encoding::LittleEndian::BufferWriter writer(out.data(), out.size());
+    writer.Put8(kSnapshotVersion)
+        .Put8(static_cast<uint8_t>(stats.sectorCount))
+        .Put16(stats.activeSector)
+        .Put32(stats.freeBytes)
+        .Put32(stats.minFreeBytes)
+        .Put32(stats.gcCycles)
+        .Put32(stats.untimedGcCycles)
+        .Put32(stats.lastGcUs)
+        .Put32(stats.maxGcUs)
+        .Put32(stats.totalGcUs);
+    for (uint16_t i = 0; i < stats.sectorCount; ++i)
+    {
+        writer.Put32(GetEraseCount(i));
+    }
+
+    size_t written = 0;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+    out.reduce_size(written);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace nvs_telemetry
+} // namespace diag
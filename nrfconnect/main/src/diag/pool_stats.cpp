@@ -0,0 +1,237 @@
+#include "diag/pool_stats.h"
+
+#include "matter/vendor_diagnostics.h"
+
+#include <app/AppConfig.h>
+#include <app/InteractionModelEngine.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/ErrorStr.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/logging/LogV.h>
+#include <system/SystemConfig.h>
+#include <system/SystemStats.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+#ifndef CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S
+#define CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S 60
+#endif
+
+namespace diag
+{
+namespace pool_stats
+{
+
+namespace
+{
+
+constexpr uint8_t kSnapshotVersion   = 2;
+constexpr uint32_t kSampleIntervalMs = CONFIG_SOIL_HEAP_SAMPLE_INTERVAL_S * 1000U;
+
+constexpr const char * kPoolNames[kPoolCount] = { "packet buffers", "exchanges", "reads", "subscriptions" };
+
+constexpr uint16_t kCapacity[kPoolCount] = {
+    CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE,
+    CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS,
+    CHIP_IM_MAX_NUM_READS,
+    CHIP_IM_MAX_NUM_SUBSCRIPTIONS,
+};
+
+// What the SDK logs when an allocation from each pool fails. ObjectPool itself returns nullptr
+// silently; these are the callers' reports of it. The exchange manager logs a failed exchange
+// allocation in the same line as every other receive error, so exchanges only have the watermark.
+struct RefusalMessage
+{
+    Pool pool;
+    const char * text;
+};
+
+constexpr RefusalMessage kRefusalMessages[] = {
+    { Pool::PacketBuffers, "PacketBuffer: pool EMPTY" },
+    { Pool::Reads, "no resource for Read interaction" },
+    { Pool::Subscriptions, "no resource for Subscribe interaction" },
+};
+
+// Owned by the CHIP thread.
+PoolInfo sPools[kPoolCount];
+uint16_t sReported[kPoolCount]; // refusals already warned about
+bool sFullReported[kPoolCount];  // watermark already warned about
+
+// Any thread that logs.
+atomic_t sRefused[kPoolCount];
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+namespace SysStats = chip::System::Stats;
+#endif
+
+uint16_t InUse(Pool pool)
+{
+    using chip::app::InteractionModelEngine;
+    using chip::app::ReadHandler;
+
+    switch (pool)
+    {
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    case Pool::PacketBuffers:
+        return static_cast<uint16_t>(SysStats::GetResourcesInUse()[SysStats::kSystemLayer_NumPacketBufs]);
+    case Pool::Exchanges:
+        return static_cast<uint16_t>(SysStats::GetResourcesInUse()[SysStats::kExchangeMgr_NumContexts]);
+#endif
+    case Pool::Reads:
+        return static_cast<uint16_t>(
+            InteractionModelEngine::GetInstance()->GetNumActiveReadHandlers(ReadHandler::InteractionType::Read));
+    case Pool::Subscriptions:
+        return static_cast<uint16_t>(
+            InteractionModelEngine::GetInstance()->GetNumActiveReadHandlers(ReadHandler::InteractionType::Subscribe));
+    default:
+        return 0;
+    }
+}
+
+// The system layer keeps its own watermarks, which also catch bursts between samples.
+uint16_t SystemWatermark(Pool pool)
+{
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    switch (pool)
+    {
+    case Pool::PacketBuffers:
+        return static_cast<uint16_t>(SysStats::GetHighWatermarks()[SysStats::kSystemLayer_NumPacketBufs]);
+    case Pool::Exchanges:
+        return static_cast<uint16_t>(SysStats::GetHighWatermarks()[SysStats::kExchangeMgr_NumContexts]);
+    default:
+        break;
+    }
+#endif
+    return 0;
+}
+
+#if _CHIP_USE_LOGGING
+// Counts refusals, then hands every message to the platform logger unchanged.
+void LogRedirect(const char * module, uint8_t category, const char * msg, va_list args)
+{
+    if (category == chip::Logging::kLogCategory_Error || category == chip::Logging::kLogCategory_Progress)
+    {
+        char line[96];
+        va_list copy;
+        va_copy(copy, args);
+        vsnprintf(line, sizeof(line), msg, copy);
+        va_end(copy);
+
+        for (const RefusalMessage & refusal : kRefusalMessages)
+        {
+            if (strstr(line, refusal.text) != nullptr)
+            {
+                atomic_inc(&sRefused[static_cast<uint8_t>(refusal.pool)]);
+                break;
+            }
+        }
+    }
+    chip::Logging::Platform::LogV(module, category, msg, args);
+}
+#endif
+
+void Refresh()
+{
+    for (uint8_t i = 0; i < kPoolCount; ++i)
+    {
+        PoolInfo & info    = sPools[i];
+        info.inUse         = InUse(static_cast<Pool>(i));
+        info.highWatermark = std::max({ info.highWatermark, info.inUse, SystemWatermark(static_cast<Pool>(i)) });
+        info.refused       = static_cast<uint16_t>(atomic_get(&sRefused[i]));
+    }
+}
+
+void SampleTimer(chip::System::Layer *, void *)
+{
+    TakeSample();
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(kSampleIntervalMs), SampleTimer,
+                                                       nullptr);
+}
+
+} // namespace
+
+void Init()
+{
+    for (uint8_t i = 0; i < kPoolCount; ++i)
+    {
+        sPools[i].capacity = kCapacity[i];
+    }
+
+    CHIP_ERROR err = matter::vendor_diagnostics::Register(matter::vendor_diagnostics::kPoolStats, Snapshot);
+    if (err != CHIP_NO_ERROR)
+    {
+        LOG_WRN("Pool stats attribute not registered: %s", chip::ErrorStr(err));
+    }
+#if _CHIP_USE_LOGGING
+    chip::Logging::SetLogRedirectCallback(LogRedirect);
+#endif
+
+    (void) chip::DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) { SampleTimer(nullptr, nullptr); });
+}
+
+PoolInfo GetPool(Pool pool)
+{
+    const uint8_t index = static_cast<uint8_t>(pool);
+    return (index < kPoolCount) ? sPools[index] : PoolInfo{};
+}
+
+void TakeSample()
+{
+    Refresh();
+    for (uint8_t i = 0; i < kPoolCount; ++i)
+    {
+        const PoolInfo & info = sPools[i];
+        if (info.refused != sReported[i])
+        {
+            LOG_WRN("Pool %s refused %u allocations (%u/%u in use, watermark %u)", kPoolNames[i],
+                    static_cast<uint16_t>(info.refused - sReported[i]), info.inUse, info.capacity, info.highWatermark);
+            sReported[i] = info.refused;
+        }
+        if (!sFullReported[i] && info.capacity != 0 && info.highWatermark >= info.capacity)
+        {
+            LOG_WRN("Pool %s reached its capacity of %u", kPoolNames[i], info.capacity);
+            sFullReported[i] = true;
+        }
+    }
+}
+
+void LogStats()
+{
+    for (uint8_t i = 0; i < kPoolCount; ++i)
+    {
+        const PoolInfo & info = sPools[i];
+        LOG_INF("Pool %-14s %u/%u in use, watermark %u, refused %u", kPoolNames[i], info.inUse, info.capacity,
+                info.highWatermark, info.refused);
+    }
+}
+
+CHIP_ERROR Snapshot(chip::MutableByteSpan & out)
+{
+    // Reads only refresh the values; counting and warnings stay with the periodic sample.
+    Refresh();
+
+    chip::Encoding::LittleEndian::BufferWriter writer(out.data(), out.size());
+    writer.Put8(kSnapshotVersion).Put8(kPoolCount).Put16(0);
+    for (const PoolInfo & info : sPools)
+    {
+        writer.Put16(info.capacity).Put16(info.inUse).Put16(info.highWatermark).Put16(info.refused);
+    }
+
+    size_t written = 0;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+    out.reduce_size(written);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace pool_stats
+} // namespace diag
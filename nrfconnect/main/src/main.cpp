@@ -11,14 +11,29 @@
 #include <data-model-providers/codegen/Instance.h>
 #include "matter/SoilDeviceInfoProvider.h"
 #include "app/AppTask.h"
+#include "app/boot_orchestrator.h"
 #include "app/factory_reset.h"
+#include "app/reboot.h"
 #include "cfg/app_config.h"
+#include "cfg/settings_writeback.h"
 #include "connectivity/ble_manager.h"
+#include "connectivity/thread_sed.h"
+#include "connectivity/wifi_power_policy.h"
+#include "connectivity/wifi_reconnect.h"
+#include "connectivity/wifi_scan_cache.h"
+#include "diag/boot_timeline.h"
+#include "diag/commissioning_timeline.h"
+#include "diag/heap_stats.h"
+#include "diag/pool_stats.h"
+#include "diag/nvs_telemetry.h"
 #include "matter/access_manager.h"
+#include "matter/acl_cache.h"
 #include "matter/ep0_im_sanitizer.h"
 #include "matter/ep0_metadata_filter.h"
 #include "matter/ep0_timesync_delegate.h"
 #include "matter/server_runtime.h"
+#include "matter/session_resumption.h"
+#include "matter/time_service.h"
 #include "sensors/soil_moisture_sensor.h"
 #include <platform/nrfconnect/DeviceInstanceInfoProviderImpl.h>
 #include <platform/CHIPDeviceEvent.h>
@@ -34,6 +49,7 @@
 #include <lib/support/logging/CHIPLogging.h>
 #include <zephyr/sys/util.h>
 #include <platform/ConfigurationManager.h>
+#include <platform/KvsPersistentStorageDelegate.h>
 
 #ifdef CONFIG_PM
 #include <zephyr/pm/pm.h>
@@ -74,27 +90,28 @@ extern "C" void RegisterGenDiagAttrAccess();
 extern "C" void MatterAppPlatform_RevisionSanityCheck();
 extern "C" void MatterAppPlatform_RegisterGkmRevisionOverride();
 
-extern "C" int main(void)
-{
-    printk("boot\n");
-    LOG_INF("Soil sensor app started.");
-
-    // Do not load settings yet; BLE Manager enables BT and will register
-    // its settings handlers. We load settings right after CHIP stack init.
-
-    // Start Matter immediately (no pre-wifi wait!)
-    int settingsStatus = cfg::app_config::InitSettings();
-    if (settingsStatus) {
-        LOG_ERR("settings_subsys_init failed: %d", settingsStatus);
-        return 0;
-    }
+namespace {
 
-    CHIP_ERROR err = PlatformMgr().InitChipStack();
-    if (err != CHIP_NO_ERROR) {
-        LOG_ERR("InitChipStack failed: %s (%" CHIP_ERROR_FORMAT ")", chip::ErrorStr(err), err.Format());
-        return 0;
-    }
+using ::app::boot_orchestrator::DependsOn;
+using diag::boot_timeline::Phase;
 
+enum BootStep : uint8_t
+{
+    kStepAppTask = 0,
+    kStepSettingsLoad,
+    kStepWifi,
+    kStepServer,
+    kStepRegistrations,
+    kStepAccessControl,
+    kStepClusters,
+    kStepOnboardingLog,
+    kStepEventLoop,
+    kStepAdvertising,
+    kStepCount,
+};
+
+bool StartAppTask()
+{
     // Provide development Device Attestation Credentials (DAC) for commissioning
     Credentials::SetDeviceAttestationCredentialsProvider(Credentials::Examples::GetExampleDACProvider());
 
@@ -103,45 +120,94 @@ extern "C" int main(void)
 
     // Register handlers for factory reset prep and BLE-related platform events
     PlatformMgr().AddEventHandler(::app::factory_reset::FactoryResetEventHandler, 0);
+    PlatformMgr().AddEventHandler(::app::reboot::AppEventHandler, 0);
     PlatformMgr().AddEventHandler(connectivity::ble_manager::AppEventHandler, 0);
+    PlatformMgr().AddEventHandler(connectivity::wifi_power_policy::AppEventHandler, 0);
+    PlatformMgr().AddEventHandler(connectivity::wifi_reconnect::AppEventHandler, 0);
+    PlatformMgr().AddEventHandler(connectivity::wifi_scan_cache::AppEventHandler, 0);
+    diag::commissioning_timeline::Init();
+    PlatformMgr().AddEventHandler(diag::commissioning_timeline::AppEventHandler, 0);
+    PlatformMgr().AddEventHandler(diag::heap_stats::AppEventHandler, 0);
 
     CHIP_ERROR appTaskErr = AppTask::Instance().StartApp();
     if (appTaskErr != CHIP_NO_ERROR)
     {
         LOG_ERR("AppTask start failed: %s (%" CHIP_ERROR_FORMAT ")", chip::ErrorStr(appTaskErr), appTaskErr.Format());
-        return 0;
+        return false;
     }
 
-    // Load Zephyr settings now that CHIP stack (and BT) are initialized.
-    cfg::app_config::LoadSettingsIfEnabled();
-
-// (Wi‑Fi commissioning registration moved after Server init)
-
     // Use standard CHIP BLE advertising (service data in ADV, name in scan response).
     // Only set a distinctive device name for easier discovery.
     connectivity::ble_manager::ConfigureDeviceName();
+    connectivity::ble_manager::InitLinkTuning();
+    return true;
+}
 
-    // Defer enabling BLE advertising until after Server init and event loop start
-    // to avoid races where a central connects before rendezvous is fully ready.
+bool LoadSettings()
+{
+    // Only BT host handlers are loaded here; CHIP reads its keys directly.
+    cfg::app_config::LoadSettingsIfEnabled();
+    return true;
+}
+
+bool StartWifi()
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_THREAD
+    // Thread builds (prj_thread_sed.conf) bring up OpenThread as a sleepy end device instead.
+    if (connectivity::thread_sed::Init() != CHIP_NO_ERROR)
+    {
+        return false;
+    }
+    matter::server_runtime::InitThreadCommissioningCluster();
+#else
+    // Registering the network commissioning cluster initializes the Wi-Fi driver, which starts
+    // connecting to the stored network. Doing it before server init overlaps association and
+    // DHCP with the rest of boot.
+    matter::server_runtime::InitWifiCommissioningCluster();
+    // Tracks that connect; needs the driver up for the provisioned network.
+    connectivity::wifi_reconnect::Init();
+    connectivity::wifi_power_policy::Init();
+#endif
+    return true;
+}
+
+bool InitServer()
+{
+    // Route the server's persistent storage through the write-back layer so churny runtime state
+    // (session resumption, subscriptions, Last Known Good Time) is coalesced before reaching NVS.
+    // Must be set before InitializeStaticResourcesBeforeServerInit(), which otherwise installs its own.
+    static chip::KvsPersistentStorageDelegate sKvsStorage;
+    static cfg::settings_writeback::WriteBackStorageDelegate sWriteBackStorage(sKvsStorage);
+    cfg::settings_writeback::Init();
+    CHIP_ERROR err = sKvsStorage.Init(&chip::DeviceLayer::PersistedStorage::KeyValueStoreMgr());
+    if (err != CHIP_NO_ERROR) {
+        LOG_ERR("KVS storage init failed: %ld", (long)err.AsInteger());
+        return false;
+    }
 
     chip::CommonCaseDeviceServerInitParams initParams;
+    initParams.persistentStorageDelegate = &sWriteBackStorage;
     err = initParams.InitializeStaticResourcesBeforeServerInit();
     if (err != CHIP_NO_ERROR) {
         LOG_ERR("Init static server resources failed: %ld", (long)err.AsInteger());
-        return -3;
+        return false;
     }
+    initParams.accessDelegate = matter::acl_cache::Wrap(initParams.accessDelegate);
+    initParams.sessionResumptionStorage = matter::session_resumption::Wrap(initParams.sessionResumptionStorage);
     // Provide a data model provider for the server (required by recent CHIP)
     chip::app::DataModel::Provider * baseProvider =
         chip::app::CodegenDataModelProviderInstance(initParams.persistentStorageDelegate);
     static matter::ep0::MetadataFilter sMetadataFilter(*baseProvider);
     initParams.dataModelProvider = &sMetadataFilter;
 
-    chip::Server & server = chip::Server::GetInstance();
+    err = chip::Server::GetInstance().Init(initParams);
 
-    err = server.Init(initParams);
-
-    if (err != CHIP_NO_ERROR) { LOG_ERR("Matter Server init failed: %ld", (long)err.AsInteger()); return -2; }
+    if (err != CHIP_NO_ERROR) { LOG_ERR("Matter Server init failed: %ld", (long)err.AsInteger()); return false; }
+    return true;
+}
 
+bool RegisterOverrides()
+{
     if (matter::ep0::RegisterTimeSyncDelegate() != CHIP_NO_ERROR)
     {
         ChipLogError(AppServer, "Failed to register TimeSync attribute access override");
@@ -153,8 +219,15 @@ extern "C" int main(void)
 
     matter::server_runtime::InitEventLogging();
     matter::server_runtime::ConfigureDynamicMrp();
+    matter::server_runtime::ResumeSubscriptionsWhenOnline();
 
     MatterAppPlatform_RevisionSanityCheck();
+    return true;
+}
+
+bool InitAccessControl()
+{
+    chip::Server & server = chip::Server::GetInstance();
 
     CHIP_ERROR managementErr = matter::access_manager::InitManagementClusters();
     if (managementErr != CHIP_NO_ERROR)
@@ -167,11 +240,13 @@ extern "C" int main(void)
     matter::access_manager::InitializeFabricHandlers(server);
 
     matter::access_manager::OpenCommissioningWindowIfNeeded(server);
+    return true;
+}
 
-    (void) chip::System::SystemClock().SetClock_RealTime(chip::System::SystemClock().GetMonotonicMicroseconds64());
-
-
-    matter::server_runtime::InitWifiCommissioningCluster();
+bool InitClusters()
+{
+    // Real time stays unsynced until SetUTCTime anchors the time service; uptime is not UTC.
+    matter::time_service::Init();
 
     // Do not set RealTime from Last Known Good Time here; CASE session handling
     // will fall back appropriately and update LKG as needed during commissioning.
@@ -180,13 +255,21 @@ extern "C" int main(void)
     {
         sensors::soil_moisture_sensor::Init();
     }
+    return true;
+}
 
+bool LogOnboarding()
+{
     // Print device configuration and onboarding codes to UART (like desktop examples)
     ConfigurationMgr().LogDeviceConfig();
     PrintOnboardingCodes(chip::RendezvousInformationFlags(chip::RendezvousInformationFlag::kBLE));
+    return true;
+}
 
+bool StartEventLoop()
+{
     // Start CHIP event loop thread (required for BLE and commissioning flows)
-    err = PlatformMgr().StartEventLoopTask();
+    CHIP_ERROR err = PlatformMgr().StartEventLoopTask();
     if (err != CHIP_NO_ERROR) {
         LOG_ERR("StartEventLoopTask failed: %ld", (long)err.AsInteger());
     }
@@ -194,8 +277,66 @@ extern "C" int main(void)
     // Ensure DeviceInfo provider uses persistent storage from the server
     gExampleDeviceInfoProvider.SetStorageDelegate(&chip::Server::GetInstance().GetPersistentStorage());
     DeviceLayer::SetDeviceInfoProvider(&gExampleDeviceInfoProvider);
+    return true;
+}
 
+bool StartAdvertising()
+{
     connectivity::ble_manager::EnableAdvertising();
+    return true;
+}
+
+// Everything touching the CHIP stack stays on main() until the event loop owns it, so the steps run
+// one after another; the dependencies fix their order. Wi-Fi bring-up follows settings_load, since
+// wifi_reconnect restores its records at Init and may start connecting straight away. The event
+// loop waits for it so BLE never advertises before the BT identity is loaded.
+constexpr ::app::boot_orchestrator::Step kBootSteps[kStepCount] = {
+    { "app task", DependsOn(), Phase::AppTaskStart, StartAppTask },
+    { "settings load", DependsOn(kStepAppTask), Phase::SettingsLoad, LoadSettings },
+    { "wifi", DependsOn(kStepAppTask, kStepSettingsLoad), Phase::WifiInit, StartWifi },
+    { "server", DependsOn(kStepAppTask), Phase::ServerInit, InitServer },
+    { "registrations", DependsOn(kStepServer), Phase::Registrations, RegisterOverrides },
+    { "access control", DependsOn(kStepRegistrations), Phase::AccessControl, InitAccessControl },
+    { "clusters", DependsOn(kStepAccessControl, kStepWifi), Phase::ClusterInit, InitClusters },
+    { "onboarding log", DependsOn(kStepClusters), Phase::OnboardingLog, LogOnboarding },
+    { "event loop", DependsOn(kStepOnboardingLog, kStepSettingsLoad), Phase::EventLoopStart, StartEventLoop },
+    { "advertising", DependsOn(kStepEventLoop), Phase::Advertising, StartAdvertising },
+};
+
+} // namespace
+
+extern "C" int main(void)
+{
+    diag::boot_timeline::Begin();
+    printk("boot\n");
+    LOG_INF("Soil sensor app started.");
+
+    // Do not load settings yet; BLE Manager enables BT and will register
+    // its settings handlers. We load settings right after CHIP stack init.
+
+    // Start Matter immediately (no pre-wifi wait!)
+    int settingsStatus = cfg::app_config::InitSettings();
+    if (settingsStatus) {
+        LOG_ERR("settings_subsys_init failed: %d", settingsStatus);
+        return 0;
+    }
+    diag::nvs_telemetry::Init();
+    diag::boot_timeline::Mark(diag::boot_timeline::Phase::SettingsInit);
+
+    CHIP_ERROR err = PlatformMgr().InitChipStack();
+    if (err != CHIP_NO_ERROR) {
+        LOG_ERR("InitChipStack failed: %s (%" CHIP_ERROR_FORMAT ")", chip::ErrorStr(err), err.Format());
+        return 0;
+    }
+    diag::boot_timeline::Mark(diag::boot_timeline::Phase::ChipStackInit);
+    diag::heap_stats::Init();
+    diag::pool_stats::Init();
+
+    if (!::app::boot_orchestrator::Run(kBootSteps, ARRAY_SIZE(kBootSteps)))
+    {
+        return -2;
+    }
+    diag::boot_timeline::Complete();
 
     while (true) { k_sleep(K_SECONDS(5)); }
 }
@@ -1,5 +1,7 @@
 #include "matter/SoilDeviceInfoProvider.h"
 
+#include "cfg/config_cache.h"
+
 #include <lib/support/CHIPMemString.h>
 #include <lib/support/CodeUtils.h>
 
@@ -60,5 +62,20 @@ CHIP_ERROR SoilDeviceInstanceInfoProvider::GetProductPrimaryColor(app::Clusters:
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR SoilDeviceInstanceInfoProvider::GetSerialNumber(char * buf, size_t bufSize)
+{
+    return cfg::config_cache::GetSerialNumber(buf, bufSize);
+}
+
+CHIP_ERROR SoilDeviceInstanceInfoProvider::GetManufacturingDate(uint16_t & year, uint8_t & month, uint8_t & day)
+{
+    return cfg::config_cache::GetManufacturingDate(year, month, day);
+}
+
+CHIP_ERROR SoilDeviceInstanceInfoProvider::GetHardwareVersion(uint16_t & hardwareVersion)
+{
+    return cfg::config_cache::GetHardwareVersion(hardwareVersion);
+}
+
 } // namespace DeviceLayer
 } // namespace chip
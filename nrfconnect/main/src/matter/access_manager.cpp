@@ -1,5 +1,8 @@
 #include "matter/access_manager.h"
 
+#include "cfg/settings_writeback.h"
+#include "matter/acl_cache.h"
+
 #include <access/AccessControl.h>
 #include <app/CASESessionManager.h>
 #include <app/FailSafeContext.h>
@@ -22,7 +25,6 @@
 #include <transport/Session.h>
 #include <transport/SessionManager.h>
 #include <vector>
-#include <zephyr/settings/settings.h>
 
 LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
 
@@ -94,6 +96,7 @@ public:
     void OnEntryChanged(const chip::Access::SubjectDescriptor *, chip::FabricIndex, size_t,
                         const chip::Access::AccessControl::Entry *, ChangeType) override
     {
+        matter::acl_cache::Invalidate();
         NotifyAclChanged();
     }
 };
@@ -303,13 +306,9 @@ CHIP_ERROR DoFullMatterWipe()
 
     server.GetFailSafeContext().DisarmFailSafe();
 
-    PlatformMgr().ScheduleWork([](intptr_t) {
-        int rc = settings_save();
-        if (rc != 0)
-        {
-            LOG_WRN("settings_save failed: %d", rc);
-        }
-    });
+    // Anything still pending describes the state just wiped; flushing it would resurrect it.
+    // The reboot that follows re-populates settings, so no settings_save() pass is needed.
+    cfg::settings_writeback::Discard();
 
     ChipLogProgress(AppServer, "DoFullMatterWipe completed");
 
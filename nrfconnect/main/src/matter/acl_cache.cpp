@@ -0,0 +1,220 @@
+#include "matter/acl_cache.h"
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#ifndef CONFIG_SOIL_ACL_CACHE_ENTRIES
+#define CONFIG_SOIL_ACL_CACHE_ENTRIES 1
+#endif
+
+namespace matter
+{
+namespace acl_cache
+{
+
+namespace
+{
+
+using chip::Access::AccessControl;
+using chip::Access::AuthMode;
+using chip::Access::Privilege;
+using chip::Access::RequestPath;
+using chip::Access::SubjectDescriptor;
+
+constexpr size_t kEntries        = CONFIG_SOIL_ACL_CACHE_ENTRIES;
+constexpr uint32_t kLogEveryMiss = 64;
+
+struct Key
+{
+    chip::FabricIndex fabricIndex;
+    AuthMode authMode;
+    Privilege privilege;
+    chip::Access::RequestType requestType;
+    chip::EndpointId endpoint;
+    chip::ClusterId cluster;
+    chip::NodeId subject;
+    chip::CATValues cats;
+
+    bool operator==(const Key & other) const
+    {
+        return fabricIndex == other.fabricIndex && authMode == other.authMode && privilege == other.privilege &&
+            requestType == other.requestType && endpoint == other.endpoint && cluster == other.cluster &&
+            subject == other.subject && cats == other.cats;
+    }
+};
+
+struct Entry
+{
+    Key key;
+    CHIP_ERROR result;
+    bool valid;
+};
+
+Entry sEntries[kEntries];
+size_t sNextVictim = 0;
+Stats sStats       = {};
+
+Key MakeKey(const SubjectDescriptor & subject, const RequestPath & path, Privilege privilege)
+{
+    Key key;
+    key.fabricIndex = subject.fabricIndex;
+    key.authMode    = subject.authMode;
+    key.privilege   = privilege;
+    key.requestType = path.requestType;
+    key.endpoint    = path.endpoint;
+    key.cluster     = path.cluster;
+    key.subject     = subject.subject;
+    key.cats        = subject.cats;
+    return key;
+}
+
+bool IsCacheable(const SubjectDescriptor & subject)
+{
+    // PASE gets implicit administer during commissioning and is cheap to decide.
+    return subject.authMode == AuthMode::kCase || subject.authMode == AuthMode::kGroup;
+}
+
+bool IsDecision(CHIP_ERROR result)
+{
+    return result == CHIP_NO_ERROR || result == CHIP_ERROR_ACCESS_DENIED;
+}
+
+// Forwards everything to the platform delegate, answering Check() from the cache when it can.
+class CachingDelegate final : public AccessControl::Delegate
+{
+public:
+    void SetInner(AccessControl::Delegate * inner) { mInner = inner; }
+
+    void Release() override { mInner->Release(); }
+    CHIP_ERROR Init() override
+    {
+        Invalidate();
+        return mInner->Init();
+    }
+    void Finish() override
+    {
+        Invalidate();
+        mInner->Finish();
+    }
+
+    CHIP_ERROR GetMaxEntriesPerFabric(size_t & value) const override { return mInner->GetMaxEntriesPerFabric(value); }
+    CHIP_ERROR GetMaxSubjectsPerEntry(size_t & value) const override { return mInner->GetMaxSubjectsPerEntry(value); }
+    CHIP_ERROR GetMaxTargetsPerEntry(size_t & value) const override { return mInner->GetMaxTargetsPerEntry(value); }
+    CHIP_ERROR GetMaxEntryCount(size_t & value) const override { return mInner->GetMaxEntryCount(value); }
+    CHIP_ERROR GetEntryCount(chip::FabricIndex fabric, size_t & value) const override
+    {
+        return mInner->GetEntryCount(fabric, value);
+    }
+    CHIP_ERROR GetEntryCount(size_t & value) const override { return mInner->GetEntryCount(value); }
+
+    CHIP_ERROR PrepareEntry(AccessControl::Entry & entry) override { return mInner->PrepareEntry(entry); }
+    CHIP_ERROR CreateEntry(size_t * index, const AccessControl::Entry & entry, chip::FabricIndex * fabricIndex) override
+    {
+        return mInner->CreateEntry(index, entry, fabricIndex);
+    }
+    CHIP_ERROR ReadEntry(size_t index, AccessControl::Entry & entry, const chip::FabricIndex * fabricIndex) const override
+    {
+        return mInner->ReadEntry(index, entry, fabricIndex);
+    }
+    CHIP_ERROR UpdateEntry(size_t index, const AccessControl::Entry & entry, const chip::FabricIndex * fabricIndex) override
+    {
+        return mInner->UpdateEntry(index, entry, fabricIndex);
+    }
+    CHIP_ERROR DeleteEntry(size_t index, const chip::FabricIndex * fabricIndex) override
+    {
+        return mInner->DeleteEntry(index, fabricIndex);
+    }
+    CHIP_ERROR Entries(AccessControl::EntryIterator & iterator, const chip::FabricIndex * fabricIndex) const override
+    {
+        return mInner->Entries(iterator, fabricIndex);
+    }
+
+    CHIP_ERROR Check(const SubjectDescriptor & subject, const RequestPath & path, Privilege privilege) override;
+
+private:
+    AccessControl::Delegate * mInner = nullptr;
+    bool mComputing                  = false;
+};
+
+CachingDelegate sDelegate;
+
+CHIP_ERROR CachingDelegate::Check(const SubjectDescriptor & subject, const RequestPath & path, Privilege privilege)
+{
+    // Re-entered from the scan below: defer to the inner delegate and then the regular entry walk.
+    if (mComputing || !IsCacheable(subject))
+    {
+        if (!mComputing)
+        {
+            sStats.uncacheable++;
+        }
+        return mInner->Check(subject, path, privilege);
+    }
+
+    const Key key = MakeKey(subject, path, privilege);
+    for (const Entry & entry : sEntries)
+    {
+        if (entry.valid && entry.key == key)
+        {
+            sStats.hits++;
+            return entry.result;
+        }
+    }
+
+    mComputing        = true;
+    CHIP_ERROR result = chip::Access::GetAccessControl().Check(subject, path, privilege);
+    mComputing        = false;
+
+    if (!IsDecision(result))
+    {
+        sStats.uncacheable++;
+        return result;
+    }
+
+    Entry & victim = sEntries[sNextVictim];
+    sNextVictim    = (sNextVictim + 1) % kEntries;
+    victim         = Entry{ key, result, true };
+
+    if ((++sStats.misses % kLogEveryMiss) == 0)
+    {
+        LogStats();
+    }
+    return result;
+}
+
+} // namespace
+
+AccessControl::Delegate * Wrap(AccessControl::Delegate * inner)
+{
+    if (!IS_ENABLED(CONFIG_SOIL_ACL_CACHE) || inner == nullptr)
+    {
+        return inner;
+    }
+
+    sDelegate.SetInner(inner);
+    return &sDelegate;
+}
+
+void Invalidate()
+{
+    for (Entry & entry : sEntries)
+    {
+        entry.valid = false;
+    }
+    sNextVictim = 0;
+    sStats.invalidations++;
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+void LogStats()
+{
+    ChipLogProgress(DataManagement, "ACL cache: %u hits, %u misses, %u uncacheable, %u invalidations",
+                    static_cast<unsigned>(sStats.hits), static_cast<unsigned>(sStats.misses),
+                    static_cast<unsigned>(sStats.uncacheable), static_cast<unsigned>(sStats.invalidations));
+}
+
+} // namespace acl_cache
+} // namespace matter
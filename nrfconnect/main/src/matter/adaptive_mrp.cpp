@@ -0,0 +1,295 @@
+#include "matter/adaptive_mrp.h"
+
+#include "connectivity/wifi_power_policy.h"
+
+#include <app/server/Dnssd.h>
+#include <app/server/Server.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/NodeId.h>
+#include <lib/core/Optional.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <messaging/ReliableMessageMgr.h>
+#include <messaging/ReliableMessageProtocolConfig.h>
+#include <platform/CHIPDeviceConfig.h>
+#include <system/SystemClock.h>
+
+#if CHIP_CONFIG_MRP_ANALYTICS_ENABLED
+#include <messaging/ReliableMessageAnalyticsDelegate.h>
+#endif
+
+#include <algorithm>
+
+namespace matter
+{
+namespace adaptive_mrp
+{
+
+namespace
+{
+
+Stats sStats = {};
+
+#if CHIP_CONFIG_MRP_ANALYTICS_ENABLED && CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG
+
+using chip::Messaging::ReliableMessageAnalyticsDelegate;
+
+constexpr size_t kMaxPeers   = 8;
+constexpr size_t kMaxPending = CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE;
+
+// Advertised intervals stay inside these bounds whatever the measurements say. The idle interval
+// never drops below the power-save wakeup period, or peers retry while the radio sleeps.
+constexpr uint32_t kMinActiveMs = 200;
+constexpr uint32_t kMaxActiveMs = 1000;
+constexpr uint32_t kMinIdleMs   = std::max<uint32_t>(500, connectivity::wifi_power_policy::kIdleWakeupPeriodMs);
+constexpr uint32_t kMaxIdleMs   = std::max<uint32_t>(3000, kMinIdleMs);
+
+constexpr uint64_t kRetuneEveryMs     = 30 * 1000;
+constexpr uint64_t kPeerStaleAfterMs  = 10 * 60 * 1000;
+constexpr uint32_t kHysteresisPercent = 20;
+
+struct Peer
+{
+    chip::FabricIndex fabricIndex;
+    chip::NodeId nodeId;
+    uint32_t srttMs;
+    uint32_t rttVarMs;
+    uint64_t lastSampleMs;
+};
+
+struct Pending
+{
+    chip::FabricIndex fabricIndex;
+    chip::NodeId nodeId;
+    uint32_t messageCounter;
+    uint64_t sentMs;
+    bool retransmitted;
+    bool used;
+};
+
+Peer sPeers[kMaxPeers];
+Pending sPending[kMaxPending];
+uint64_t sLastRetuneMs        = 0;
+uint32_t sRetransmitsAtRetune = 0;
+uint32_t sSendsAtRetune       = 0;
+
+uint64_t NowMs()
+{
+    return chip::System::SystemClock().GetMonotonicMilliseconds64().count();
+}
+
+uint32_t Clamp(uint32_t value, uint32_t low, uint32_t high)
+{
+    return std::min(std::max(value, low), high);
+}
+
+bool DiffersEnough(uint32_t current, uint32_t target)
+{
+    const uint32_t delta = (current > target) ? current - target : target - current;
+    return delta * 100 > current * kHysteresisPercent;
+}
+
+Pending * FindPending(const ReliableMessageAnalyticsDelegate::TransmitEvent & event)
+{
+    for (Pending & entry : sPending)
+    {
+        if (entry.used && entry.messageCounter == event.messageCounter && entry.nodeId == event.nodeId &&
+            entry.fabricIndex == event.fabricIndex)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+Peer & PeerFor(chip::FabricIndex fabricIndex, chip::NodeId nodeId)
+{
+    Peer * oldest = &sPeers[0];
+    for (Peer & peer : sPeers)
+    {
+        if (peer.fabricIndex == fabricIndex && peer.nodeId == nodeId)
+        {
+            return peer;
+        }
+        if (peer.lastSampleMs < oldest->lastSampleMs)
+        {
+            oldest = &peer;
+        }
+    }
+
+    *oldest             = Peer{};
+    oldest->fabricIndex = fabricIndex;
+    oldest->nodeId      = nodeId;
+    return *oldest;
+}
+
+void AddSample(Peer & peer, uint32_t rttMs, uint64_t nowMs)
+{
+    if (peer.lastSampleMs == 0)
+    {
+        peer.srttMs   = rttMs;
+        peer.rttVarMs = rttMs / 2;
+    }
+    else
+    {
+        const uint32_t error = (peer.srttMs > rttMs) ? peer.srttMs - rttMs : rttMs - peer.srttMs;
+        peer.rttVarMs        = (3 * peer.rttVarMs + error) / 4;
+        peer.srttMs          = (7 * peer.srttMs + rttMs) / 8;
+    }
+    peer.lastSampleMs = nowMs;
+    sStats.rttSamples++;
+}
+
+void Retune(uint64_t nowMs)
+{
+    sLastRetuneMs = nowMs;
+
+    uint32_t worstRtoMs = 0;
+    for (const Peer & peer : sPeers)
+    {
+        if (peer.lastSampleMs != 0 && nowMs - peer.lastSampleMs < kPeerStaleAfterMs)
+        {
+            worstRtoMs = std::max(worstRtoMs, peer.srttMs + 4 * peer.rttVarMs);
+        }
+    }
+    if (worstRtoMs == 0)
+    {
+        return;
+    }
+
+    const uint32_t activeMs = Clamp(2 * worstRtoMs, kMinActiveMs, kMaxActiveMs);
+    const uint32_t idleMs   = Clamp(4 * worstRtoMs, std::max(kMinIdleMs, activeMs), kMaxIdleMs);
+    if (!DiffersEnough(sStats.activeIntervalMs, activeMs) && !DiffersEnough(sStats.idleIntervalMs, idleMs))
+    {
+        return;
+    }
+
+    const uint32_t sends       = sStats.initialSends - sSendsAtRetune;
+    const uint32_t retransmits = sStats.retransmissions - sRetransmitsAtRetune;
+    ChipLogProgress(ExchangeManager, "MRP retune: RTO %u ms, idle %u->%u ms, active %u->%u ms (%u retransmits / %u sends)",
+                    static_cast<unsigned>(worstRtoMs), static_cast<unsigned>(sStats.idleIntervalMs),
+                    static_cast<unsigned>(idleMs), static_cast<unsigned>(sStats.activeIntervalMs),
+                    static_cast<unsigned>(activeMs), static_cast<unsigned>(retransmits), static_cast<unsigned>(sends));
+    sSendsAtRetune       = sStats.initialSends;
+    sRetransmitsAtRetune = sStats.retransmissions;
+
+    chip::ReliableMessageProtocolConfig config(chip::System::Clock::Milliseconds32(idleMs),
+                                               chip::System::Clock::Milliseconds32(activeMs));
+    sStats.idleIntervalMs   = idleMs;
+    sStats.activeIntervalMs = activeMs;
+    sStats.retunes++;
+
+    // Peers pick up the new intervals from our operational DNS-SD record and new sessions.
+    if (chip::SetLocalMRPConfig(chip::MakeOptional(config)))
+    {
+        (void) chip::app::DnssdServer::Instance().AdvertiseOperational();
+    }
+}
+
+class AnalyticsDelegate final : public ReliableMessageAnalyticsDelegate
+{
+public:
+    void OnTransmitEvent(const TransmitEvent & event) override;
+};
+
+AnalyticsDelegate sDelegate;
+
+void AnalyticsDelegate::OnTransmitEvent(const TransmitEvent & event)
+{
+    const uint64_t nowMs = NowMs();
+    Pending * pending    = FindPending(event);
+
+    switch (event.eventType)
+    {
+    case EventType::kInitialSend: {
+        sStats.initialSends++;
+        Pending * slot = &sPending[0];
+        for (Pending & entry : sPending)
+        {
+            if (!entry.used)
+            {
+                slot = &entry;
+                break;
+            }
+            if (entry.sentMs < slot->sentMs)
+            {
+                slot = &entry;
+            }
+        }
+        *slot = Pending{ event.fabricIndex, event.nodeId, event.messageCounter, nowMs, false, true };
+        break;
+    }
+    case EventType::kRetransmission:
+        sStats.retransmissions++;
+        if (pending != nullptr)
+        {
+            pending->retransmitted = true;
+        }
+        break;
+    case EventType::kAcknowledged:
+        sStats.acks++;
+        if (pending != nullptr)
+        {
+            // Karn: an ACK after a retransmission cannot be matched to one send, so no sample.
+            if (!pending->retransmitted)
+            {
+                AddSample(PeerFor(event.fabricIndex, event.nodeId), static_cast<uint32_t>(nowMs - pending->sentMs), nowMs);
+            }
+            pending->used = false;
+        }
+        break;
+    case EventType::kFailed:
+        sStats.failures++;
+        if (pending != nullptr)
+        {
+            pending->used = false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (nowMs - sLastRetuneMs >= kRetuneEveryMs)
+    {
+        Retune(nowMs);
+    }
+}
+
+#endif // CHIP_CONFIG_MRP_ANALYTICS_ENABLED && CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG
+
+} // namespace
+
+void Init(uint32_t idleIntervalMs, uint32_t activeIntervalMs)
+{
+    sStats.idleIntervalMs   = idleIntervalMs;
+    sStats.activeIntervalMs = activeIntervalMs;
+
+#if CHIP_CONFIG_MRP_ANALYTICS_ENABLED && CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG
+    if (!IS_ENABLED(CONFIG_SOIL_ADAPTIVE_MRP))
+    {
+        return;
+    }
+
+    sLastRetuneMs = NowMs();
+    chip::Server::GetInstance().GetExchangeManager().GetReliableMessageMgr()->RegisterAnalyticsDelegate(&sDelegate);
+#else
+    ChipLogProgress(ExchangeManager, "Adaptive MRP unavailable: needs MRP analytics and dynamic MRP config");
+#endif
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+void LogStats()
+{
+    ChipLogProgress(ExchangeManager,
+                    "MRP: %u sends, %u retransmits, %u acks, %u failures, %u RTT samples, %u retunes (idle %u ms, active %u ms)",
+                    static_cast<unsigned>(sStats.initialSends), static_cast<unsigned>(sStats.retransmissions),
+                    static_cast<unsigned>(sStats.acks), static_cast<unsigned>(sStats.failures),
+                    static_cast<unsigned>(sStats.rttSamples), static_cast<unsigned>(sStats.retunes),
+                    static_cast<unsigned>(sStats.idleIntervalMs), static_cast<unsigned>(sStats.activeIntervalMs));
+}
+
+} // namespace adaptive_mrp
+} // namespace matter
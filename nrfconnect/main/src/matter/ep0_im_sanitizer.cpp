@@ -1,5 +1,7 @@
 #include "ep0_im_sanitizer.h"
 
+#include "cfg/config_cache.h"
+
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app-common/zap-generated/ids/Clusters.h>
 #include <app/AttributeAccessInterfaceRegistry.h>
@@ -62,6 +64,11 @@ constexpr chip::ClusterId kRootServerClusters[] = {
     chip::app::Clusters::GeneralCommissioning::Id,
     chip::app::Clusters::NetworkCommissioning::Id,
     chip::app::Clusters::GeneralDiagnostics::Id,
+#if defined(CONFIG_CHIP_WIFI)
+    chip::app::Clusters::WiFiNetworkDiagnostics::Id,
+#elif defined(CONFIG_NET_L2_OPENTHREAD)
+    chip::app::Clusters::ThreadNetworkDiagnostics::Id,
+#endif
     chip::app::Clusters::AdministratorCommissioning::Id,
     chip::app::Clusters::OperationalCredentials::Id,
     chip::app::Clusters::GroupKeyManagement::Id,
@@ -117,8 +124,7 @@ CHIP_ERROR AttrListSanitizer::Read(const ConcreteReadAttributePath & aPath, Attr
         if (aPath.mAttributeId == kBasicInfoUniqueId)
         {
             char uniqueId[chip::DeviceLayer::ConfigurationManager::kMaxUniqueIDLength + 1] = {};
-            CHIP_ERROR err                                                                    =
-                chip::DeviceLayer::ConfigurationMgr().GetUniqueId(uniqueId, sizeof(uniqueId));
+            CHIP_ERROR err = cfg::config_cache::GetUniqueId(uniqueId, sizeof(uniqueId));
 
             if (err == CHIP_NO_ERROR && uniqueId[0] != '\0')
             {
@@ -132,7 +138,7 @@ CHIP_ERROR AttrListSanitizer::Read(const ConcreteReadAttributePath & aPath, Attr
         if (aPath.mAttributeId == kBasicInfoConfigurationVersion)
         {
             uint32_t configurationVersion = 0;
-            CHIP_ERROR err                = chip::DeviceLayer::ConfigurationMgr().GetConfigurationVersion(configurationVersion);
+            CHIP_ERROR err                = cfg::config_cache::GetConfigurationVersion(configurationVersion);
 
             if (err != CHIP_NO_ERROR)
             {
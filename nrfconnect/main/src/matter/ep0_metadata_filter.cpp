@@ -1,9 +1,19 @@
 #include "ep0_metadata_filter.h"
 
+#include "cfg/config_cache.h"
+#include "diag/commissioning_timeline.h"
+#include "matter/report_cache.h"
+#include "matter/vendor_diagnostics.h"
+#include "sensors/soil_threshold_events.h"
+
 #include <app-common/zap-generated/ids/Attributes.h>
 #include <app-common/zap-generated/ids/Clusters.h>
+#include <app-common/zap-generated/ids/Commands.h>
 #include <app/ConcreteAttributePath.h>
+#include <app/ConcreteCommandPath.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <platform/ConfigurationManager.h>
 #include <protocols/interaction_model/Constants.h>
 
 namespace matter {
@@ -11,6 +21,20 @@ namespace ep0 {
 namespace {
 constexpr chip::EndpointId kRootEndpoint             = 0;
 constexpr chip::ClusterId kBasicInformationClusterId = chip::app::Clusters::BasicInformation::Id;
+constexpr chip::AttributeId kLocationId              = chip::app::Clusters::BasicInformation::Attributes::Location::Id;
+
+bool IsBasicInformationLocation(const chip::app::ConcreteAttributePath & path)
+{
+    return (path.mEndpointId == kRootEndpoint) && (path.mClusterId == kBasicInformationClusterId) &&
+        (path.mAttributeId == kLocationId);
+}
+
+// SetRegulatoryConfig stores its country code through ConfigurationMgr(), bypassing the cache.
+bool IsSetRegulatoryConfig(const chip::app::ConcreteCommandPath & path)
+{
+    return (path.mEndpointId == kRootEndpoint) && (path.mClusterId == chip::app::Clusters::GeneralCommissioning::Id) &&
+        (path.mCommandId == chip::app::Clusters::GeneralCommissioning::Commands::SetRegulatoryConfig::Id);
+}
 } // namespace
 
 MetadataFilter::MetadataFilter(chip::app::DataModel::Provider & inner) : mInner(&inner) {}
@@ -52,6 +76,42 @@ MetadataFilter::ReadAttribute(const chip::app::DataModel::ReadAttributeRequest &
         return chip::Protocols::InteractionModel::Status::Success;
     }
 
+    CHIP_ERROR vendorErr = CHIP_NO_ERROR;
+    if (matter::vendor_diagnostics::TryRead(request.path, encoder, vendorErr))
+    {
+        if (vendorErr != CHIP_NO_ERROR)
+        {
+            return vendorErr;
+        }
+        return chip::Protocols::InteractionModel::Status::Success;
+    }
+
+    // The Basic Information cluster reads Location straight from ConfigurationManager on every report.
+    if (IsBasicInformationLocation(request.path))
+    {
+        char countryCode[chip::DeviceLayer::ConfigurationManager::kMaxLocationLength + 1] = {};
+        size_t codeLen                                                               = 0;
+        if (cfg::config_cache::GetCountryCode(countryCode, sizeof(countryCode), codeLen) == CHIP_NO_ERROR)
+        {
+            CHIP_ERROR err = encoder.Encode(chip::CharSpan(countryCode, codeLen));
+            if (err != CHIP_NO_ERROR)
+            {
+                return err;
+            }
+            return chip::Protocols::InteractionModel::Status::Success;
+        }
+    }
+
+    CHIP_ERROR cachedErr = CHIP_NO_ERROR;
+    if (matter::report_cache::TryEncode(request.path, encoder, cachedErr))
+    {
+        if (cachedErr != CHIP_NO_ERROR)
+        {
+            return cachedErr;
+        }
+        return chip::Protocols::InteractionModel::Status::Success;
+    }
+
     return mInner->ReadAttribute(request, encoder);
 }
 
@@ -59,7 +119,13 @@ chip::app::DataModel::ActionReturnStatus
 MetadataFilter::WriteAttribute(const chip::app::DataModel::WriteAttributeRequest & request,
                                chip::app::AttributeValueDecoder & decoder)
 {
-    return mInner->WriteAttribute(request, decoder);
+    chip::app::DataModel::ActionReturnStatus status = mInner->WriteAttribute(request, decoder);
+    if (IsBasicInformationLocation(request.path))
+    {
+        // Drop the cached copy whatever the outcome; the next read reloads what was actually stored.
+        cfg::config_cache::InvalidateCountryCode();
+    }
+    return status;
 }
 
 void MetadataFilter::ListAttributeWriteNotification(const chip::app::ConcreteAttributePath & aPath,
@@ -72,7 +138,14 @@ std::optional<chip::app::DataModel::ActionReturnStatus> MetadataFilter::InvokeCo
     const chip::app::DataModel::InvokeRequest & request, chip::TLV::TLVReader & input_arguments,
     chip::app::CommandHandler * handler)
 {
-    return mInner->InvokeCommand(request, input_arguments, handler);
+    auto status = mInner->InvokeCommand(request, input_arguments, handler);
+    if (IsSetRegulatoryConfig(request.path))
+    {
+        // As for Location writes: drop the cached copy and reload what was actually stored.
+        cfg::config_cache::InvalidateCountryCode();
+    }
+    diag::commissioning_timeline::OnCommandHandled(request.path);
+    return status;
 }
 
 CHIP_ERROR MetadataFilter::Endpoints(chip::ReadOnlyBufferBuilder<chip::app::DataModel::EndpointEntry> & builder)
@@ -108,6 +181,12 @@ CHIP_ERROR MetadataFilter::ServerClusters(
 CHIP_ERROR MetadataFilter::EventInfo(const chip::app::ConcreteEventPath & path,
                                      chip::app::DataModel::EventEntry & eventInfo)
 {
+    if (sensors::soil_threshold_events::IsThresholdEvent(path))
+    {
+        eventInfo.readPrivilege = chip::Access::Privilege::kView;
+        return CHIP_NO_ERROR;
+    }
+
     return mInner->EventInfo(path, eventInfo);
 }
 
@@ -123,6 +202,7 @@ CHIP_ERROR MetadataFilter::Attributes(const chip::app::ConcreteClusterPath & pat
 {
     CHIP_ERROR err = mInner->Attributes(path, builder);
     ReturnErrorOnFailure(err);
+    ReturnErrorOnFailure(matter::vendor_diagnostics::AppendAttributes(path, builder));
 
     if ((path.mEndpointId != kRootEndpoint) || (path.mClusterId != kBasicInformationClusterId))
     {
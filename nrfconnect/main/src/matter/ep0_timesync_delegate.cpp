@@ -1,5 +1,7 @@
 #include "matter/ep0_timesync_delegate.h"
 
+#include "matter/time_service.h"
+
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/CommandHandler.h>
 #include <app/AttributeAccessInterfaceRegistry.h>
@@ -66,13 +68,21 @@ CHIP_ERROR TimeSyncDelegate::Read(const chip::app::ConcreteReadAttributePath & p
 
     switch (path.mAttributeId)
     {
-    case UTCTime::Id:
-        if (mUtcTime.HasValue())
+    case UTCTime::Id: {
+        uint64_t utcNow = 0;
+        if (matter::time_service::GetUtcNow(utcNow) == CHIP_NO_ERROR)
         {
-            return encoder.Encode(mUtcTime.Value());
+            return encoder.Encode(utcNow);
         }
         return encoder.EncodeNull();
+    }
     case TimeSource::Id:
+        if (matter::time_service::IsRestored())
+        {
+            // Restored from flash after a reset: usable for timestamps but not verified by a controller.
+            return encoder.Encode(
+                static_cast<uint8_t>(chip::app::Clusters::TimeSynchronization::TimeSourceEnum::kUnknown));
+        }
         return encoder.Encode(static_cast<uint8_t>(mTimeSource));
     case Granularity::Id:
         return encoder.Encode(static_cast<uint8_t>(chip::app::Clusters::TimeSynchronization::GranularityEnum::kNoTimeGranularity));
@@ -132,7 +142,6 @@ chip::Protocols::InteractionModel::Status TimeSyncDelegate::HandleSetUtcTimeComm
     }
 
     // Accept the command but avoid writing optional attributes that are not exposed on EP0.
-    mUtcTime.SetValue(commandData.UTCTime);
     const auto & timeSource = commandData.timeSource;
     mTimeSource             = timeSource.HasValue()
                         ? timeSource.Value()
@@ -149,12 +158,8 @@ chip::Protocols::InteractionModel::Status TimeSyncDelegate::HandleSetUtcTimeComm
         }
     }
 
-    CHIP_ERROR clockErr = chip::System::SystemClock().SetClock_RealTime(
-        chip::System::Clock::Microseconds64(unixEpochMicros));
-    if (clockErr != CHIP_NO_ERROR && clockErr != CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE)
-    {
-        ChipLogError(AppServer, "Failed to update real-time clock: %s", chip::ErrorStr(clockErr));
-    }
+    // Anchors the time service, refines the drift estimate and updates the platform real-time clock.
+    matter::time_service::SetUtcTime(commandData.UTCTime);
 
     if (auto * engine = chip::app::InteractionModelEngine::GetInstance(); engine != nullptr)
     {
@@ -31,7 +31,6 @@ public:
 private:
     TimeSyncDelegate();
 
-    chip::Optional<uint64_t> mUtcTime; // chip epoch microseconds
     chip::app::Clusters::TimeSynchronization::TimeSourceEnum mTimeSource;
 };
 
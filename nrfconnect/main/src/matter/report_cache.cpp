@@ -0,0 +1,164 @@
+#include "matter/report_cache.h"
+
+#include <lib/support/logging/CHIPLogging.h>
+#include <zephyr/sys/util.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace matter
+{
+namespace report_cache
+{
+
+namespace
+{
+
+constexpr uint32_t kLogEveryChanges = 64;
+
+struct Entry
+{
+    chip::app::ConcreteAttributePath path;
+    DataVersionGetter getDataVersion = nullptr;
+    chip::DataVersion dataVersion    = 0;
+    uint8_t encoded[kMaxEncodedSize];
+    uint8_t encodedLen    = 0;
+    bool valid            = false;
+    uint16_t changeFanout = 0;
+};
+
+// Copies a pre-encoded TLV element into the report under the tag chosen by the encoder.
+struct EncodedElement
+{
+    chip::ByteSpan data;
+
+    CHIP_ERROR Encode(chip::TLV::TLVWriter & writer, chip::TLV::Tag tag) const
+    {
+        chip::TLV::TLVReader reader;
+        reader.Init(data);
+        ReturnErrorOnFailure(reader.Next());
+        return writer.CopyElement(tag, reader);
+    }
+};
+
+Entry sEntries[kMaxEntries];
+size_t sEntryCount = 0;
+Stats sStats       = {};
+
+Entry * FindEntry(const chip::app::ConcreteAttributePath & path)
+{
+    for (size_t i = 0; i < sEntryCount; ++i)
+    {
+        if (sEntries[i].path == path)
+        {
+            return &sEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+CHIP_ERROR RegisterAttribute(const chip::app::ConcreteAttributePath & path, DataVersionGetter getDataVersion)
+{
+    VerifyOrReturnError(getDataVersion != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (Entry * entry = FindEntry(path); entry != nullptr)
+    {
+        entry->getDataVersion = getDataVersion;
+        entry->valid          = false;
+        return CHIP_NO_ERROR;
+    }
+
+    VerifyOrReturnError(sEntryCount < kMaxEntries, CHIP_ERROR_NO_MEMORY);
+
+    Entry & entry        = sEntries[sEntryCount++];
+    entry.path           = path;
+    entry.getDataVersion = getDataVersion;
+    entry.valid          = false;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StoreEncoded(const chip::app::ConcreteAttributePath & path, chip::ByteSpan encoded)
+{
+    if (!IS_ENABLED(CONFIG_SOIL_REPORT_ENCODE_CACHE))
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    Entry * entry = FindEntry(path);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_NOT_FOUND);
+
+    sStats.changes++;
+
+    if (entry->valid)
+    {
+        sStats.lastChangeFanout = entry->changeFanout;
+        sStats.maxChangeFanout  = std::max(sStats.maxChangeFanout, entry->changeFanout);
+    }
+
+    if (encoded.size() > sizeof(entry->encoded))
+    {
+        entry->valid = false;
+        return CHIP_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    memcpy(entry->encoded, encoded.data(), encoded.size());
+    entry->encodedLen   = static_cast<uint8_t>(encoded.size());
+    entry->dataVersion  = entry->getDataVersion();
+    entry->changeFanout = 0;
+    entry->valid        = true;
+    sStats.encodes++;
+
+    if ((sStats.changes % kLogEveryChanges) == 0)
+    {
+        LogStats();
+    }
+    return CHIP_NO_ERROR;
+}
+
+bool TryEncode(const chip::app::ConcreteAttributePath & path, chip::app::AttributeValueEncoder & encoder, CHIP_ERROR & err)
+{
+    if (!IS_ENABLED(CONFIG_SOIL_REPORT_ENCODE_CACHE))
+    {
+        return false;
+    }
+
+    Entry * entry = FindEntry(path);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    // Anything that bumped the cluster version without going through Store() invalidates the entry.
+    if (!entry->valid || entry->dataVersion != entry->getDataVersion())
+    {
+        entry->valid = false;
+        sStats.fallbacks++;
+        return false;
+    }
+
+    err = encoder.Encode(EncodedElement{ chip::ByteSpan(entry->encoded, entry->encodedLen) });
+    if (err == CHIP_NO_ERROR)
+    {
+        sStats.reuses++;
+        entry->changeFanout++;
+    }
+    return true;
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+void LogStats()
+{
+    ChipLogProgress(DataManagement, "Report cache: changes=%u encodes=%u reuses=%u fallbacks=%u fanout last=%u max=%u",
+                    static_cast<unsigned>(sStats.changes), static_cast<unsigned>(sStats.encodes),
+                    static_cast<unsigned>(sStats.reuses), static_cast<unsigned>(sStats.fallbacks),
+                    static_cast<unsigned>(sStats.lastChangeFanout), static_cast<unsigned>(sStats.maxChangeFanout));
+}
+
+} // namespace report_cache
+} // namespace matter
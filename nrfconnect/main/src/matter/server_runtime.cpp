@@ -1,7 +1,18 @@
 #include "matter/server_runtime.h"
 
+#include "connectivity/wifi_power_policy.h"
+#include "matter/adaptive_mrp.h"
+
 #include <app/EventManagement.h>
+#include <app/InteractionModelEngine.h>
+#include <lib/core/ErrorStr.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <messaging/ReliableMessageProtocolConfig.h>
+#include <platform/CHIPDeviceConfig.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <algorithm>
+#include <cinttypes>
 
 #if CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG
 #include <lib/core/Optional.h>
@@ -9,8 +20,12 @@
 #endif
 
 #if defined(CONFIG_CHIP_WIFI)
+#include "connectivity/wifi_scan_cache.h"
+
+#include <app/clusters/network-commissioning/CodegenInstance.h>
+#elif CHIP_DEVICE_CONFIG_ENABLE_THREAD
 #include <app/clusters/network-commissioning/CodegenInstance.h>
-#include <platform/nrfconnect/wifi/NrfWiFiDriver.h>
+#include <platform/OpenThread/GenericNetworkCommissioningThreadDriver.h>
 #endif
 
 namespace matter
@@ -18,30 +33,100 @@ namespace matter
 namespace server_runtime
 {
 
+namespace
+{
+
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+bool sResumedOnline = false;
+
+void ResumeOnAddressAssigned(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t)
+{
+    using chip::DeviceLayer::DeviceEventType;
+    using chip::DeviceLayer::InterfaceIpChangeType;
+
+    if (sResumedOnline || event->Type != DeviceEventType::kInterfaceIpAddressChanged ||
+        event->InterfaceIpAddressChanged.Type != InterfaceIpChangeType::kIpV6_Assigned)
+    {
+        return;
+    }
+    sResumedOnline = true;
+
+    // Subscriptions already re-established (or with a retry pending) are skipped by the engine.
+    CHIP_ERROR err = chip::app::InteractionModelEngine::GetInstance()->ResumeSubscriptions();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(InteractionModel, "Subscription resumption failed: %s", chip::ErrorStr(err));
+    }
+}
+#endif
+
+} // namespace
+
 void InitEventLogging()
 {
+    // Server::Init() wires the critical/info/debug circular buffers sized in CHIPProjectConfig.h and
+    // restores the persisted event-number counter, so numbering continues across reboots and
+    // subscribers can resume from their last seen event instead of re-reading everything.
     auto & eventManagement = chip::app::EventManagement::GetInstance();
-    (void) eventManagement;
+
+    ChipLogProgress(EventLogging, "Event buffers crit=%u info=%u debug=%u bytes, next event #%" PRIu64,
+                    static_cast<unsigned>(CHIP_DEVICE_CONFIG_EVENT_LOGGING_CRIT_BUFFER_SIZE),
+                    static_cast<unsigned>(CHIP_DEVICE_CONFIG_EVENT_LOGGING_INFO_BUFFER_SIZE),
+                    static_cast<unsigned>(CHIP_DEVICE_CONFIG_EVENT_LOGGING_DEBUG_BUFFER_SIZE),
+                    static_cast<uint64_t>(eventManagement.GetLastEventNumber() + 1));
 }
 
 void ConfigureDynamicMrp()
 {
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+    // A sleepy device is only reachable at its poll periods, which the ICD manager advertises as the
+    // MRP intervals. Anything shorter makes peers spend their retries while the radio is off.
+    ChipLogProgress(ExchangeManager, "MRP intervals follow the ICD poll periods");
+#else
+    // Starting point until adaptive_mrp has RTT samples to retune from; as there, the idle interval
+    // covers the power-save wakeup period.
+    constexpr uint32_t kIdleIntervalMs   = std::max<uint32_t>(2000, connectivity::wifi_power_policy::kIdleWakeupPeriodMs);
+    constexpr uint32_t kActiveIntervalMs = 300;
+
 #if CHIP_DEVICE_CONFIG_ENABLE_DYNAMIC_MRP_CONFIG
-    using namespace chip::System::Clock::Literals;
-    chip::Messaging::ReliableMessageProtocolConfig mrpConfig(2000_ms32, 300_ms32);
-    auto mrpOverride = chip::MakeOptional(mrpConfig);
-    (void) chip::Messaging::ReliableMessageProtocolConfig::SetLocalMRPConfig(mrpOverride);
+    chip::ReliableMessageProtocolConfig mrpConfig(chip::System::Clock::Milliseconds32(kIdleIntervalMs),
+                                                  chip::System::Clock::Milliseconds32(kActiveIntervalMs));
+    (void) chip::SetLocalMRPConfig(chip::MakeOptional(mrpConfig));
+#endif
+    matter::adaptive_mrp::Init(kIdleIntervalMs, kActiveIntervalMs);
 #endif
 }
 
 void InitWifiCommissioningCluster()
 {
 #if defined(CONFIG_CHIP_WIFI)
+    // Repeated ScanNetworks within a commissioning window are answered from the scan cache.
     static chip::app::Clusters::NetworkCommissioning::Instance sWiFiCommissioningInstance(
-        0, &(chip::DeviceLayer::NetworkCommissioning::NrfWiFiDriver::Instance()));
+        0, &connectivity::wifi_scan_cache::Driver());
     (void) sWiFiCommissioningInstance.Init();
 #endif
 }
 
+void InitThreadCommissioningCluster()
+{
+#if !defined(CONFIG_CHIP_WIFI) && CHIP_DEVICE_CONFIG_ENABLE_THREAD
+    static chip::DeviceLayer::NetworkCommissioning::GenericThreadDriver sThreadDriver;
+    static chip::app::Clusters::NetworkCommissioning::Instance sThreadCommissioningInstance(0, &sThreadDriver);
+    (void) sThreadCommissioningInstance.Init();
+#endif
+}
+
+void ResumeSubscriptionsWhenOnline()
+{
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+    sResumedOnline = false;
+    CHIP_ERROR err = chip::DeviceLayer::PlatformMgr().AddEventHandler(ResumeOnAddressAssigned, 0);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(InteractionModel, "Subscription resumption hook not installed: %s", chip::ErrorStr(err));
+    }
+#endif
+}
+
 } // namespace server_runtime
 } // namespace matter
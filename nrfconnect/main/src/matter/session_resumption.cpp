@@ -0,0 +1,213 @@
+#include "matter/session_resumption.h"
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/ScopedNodeId.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <cstring>
+
+namespace matter
+{
+namespace session_resumption
+{
+
+namespace
+{
+
+using chip::CATValues;
+using chip::ScopedNodeId;
+using chip::SessionResumptionStorage;
+using chip::Crypto::P256ECDHDerivedSecret;
+
+constexpr size_t kMaxFabricStats = CHIP_CONFIG_MAX_FABRICS;
+constexpr uint32_t kLogEveryCase = 16;
+
+FabricStats sFabricStats[kMaxFabricStats];
+Stats sStats = {};
+
+FabricStats * FindFabric(chip::FabricIndex fabricIndex, bool create)
+{
+    FabricStats * freeSlot = nullptr;
+    for (FabricStats & entry : sFabricStats)
+    {
+        if (entry.fabricIndex == fabricIndex)
+        {
+            return &entry;
+        }
+        if (freeSlot == nullptr && entry.fabricIndex == chip::kUndefinedFabricIndex)
+        {
+            freeSlot = &entry;
+        }
+    }
+
+    if (!create || freeSlot == nullptr)
+    {
+        return nullptr;
+    }
+    *freeSlot             = FabricStats{};
+    freeSlot->fabricIndex = fabricIndex;
+    return freeSlot;
+}
+
+class InstrumentedStorage final : public SessionResumptionStorage
+{
+public:
+    void SetInner(SessionResumptionStorage * inner) { mInner = inner; }
+
+    CHIP_ERROR FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                  P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override
+    {
+        CHIP_ERROR err = mInner->FindByScopedNodeId(node, resumptionId, sharedSecret, peerCATs);
+        if (err == CHIP_NO_ERROR)
+        {
+            Remember(node, sharedSecret);
+        }
+        return err;
+    }
+
+    CHIP_ERROR FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node, P256ECDHDerivedSecret & sharedSecret,
+                                  CATValues & peerCATs) override;
+    CHIP_ERROR Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId, const P256ECDHDerivedSecret & sharedSecret,
+                    const CATValues & peerCATs) override;
+    CHIP_ERROR DeleteAll(chip::FabricIndex fabricIndex) override;
+
+private:
+    void Remember(const ScopedNodeId & node, const P256ECDHDerivedSecret & sharedSecret)
+    {
+        mLookedUpNode = node;
+        (void) mLookedUpSecret.SetLength(sharedSecret.Length());
+        memcpy(mLookedUpSecret.Bytes(), sharedSecret.ConstBytes(), sharedSecret.Length());
+    }
+
+    void Forget()
+    {
+        mLookedUpNode = ScopedNodeId();
+        (void) mLookedUpSecret.SetLength(0);
+        chip::Crypto::ClearSecretData(mLookedUpSecret.Bytes(), mLookedUpSecret.Capacity());
+    }
+
+    // A resumed handshake reuses the stored shared secret; a full one derives a new one.
+    bool Resumed(const ScopedNodeId & node, const P256ECDHDerivedSecret & sharedSecret) const
+    {
+        return mLookedUpNode == node && mLookedUpSecret.Length() == sharedSecret.Length() &&
+            chip::Crypto::IsBufferContentEqualConstantTime(mLookedUpSecret.ConstBytes(), sharedSecret.ConstBytes(),
+                                                           sharedSecret.Length());
+    }
+
+    SessionResumptionStorage * mInner = nullptr;
+    // The last record handed out by a lookup, until the handshake that asked for it saves its result.
+    ScopedNodeId mLookedUpNode;
+    P256ECDHDerivedSecret mLookedUpSecret;
+};
+
+InstrumentedStorage sStorage;
+
+CHIP_ERROR InstrumentedStorage::FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                                   P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    CHIP_ERROR err = mInner->FindByResumptionId(resumptionId, node, sharedSecret, peerCATs);
+    if (err == CHIP_NO_ERROR)
+    {
+        Remember(node, sharedSecret);
+    }
+    else
+    {
+        sStats.unknownIds++;
+    }
+    return err;
+}
+
+CHIP_ERROR InstrumentedStorage::Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                     const P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    // CASESession saves the record once the handshake has completed, resumed or not.
+    CHIP_ERROR err = mInner->Save(node, resumptionId, sharedSecret, peerCATs);
+    sStats.saves++;
+
+    FabricStats * entry = FindFabric(node.GetFabricIndex(), true);
+    if (entry != nullptr)
+    {
+        if (Resumed(node, sharedSecret))
+        {
+            entry->resumed++;
+        }
+        else
+        {
+            entry->fullCase++;
+        }
+    }
+    if (mLookedUpNode == node)
+    {
+        Forget();
+    }
+
+    if ((sStats.saves % kLogEveryCase) == 0)
+    {
+        LogStats();
+    }
+    return err;
+}
+
+CHIP_ERROR InstrumentedStorage::DeleteAll(chip::FabricIndex fabricIndex)
+{
+    FabricStats * entry = FindFabric(fabricIndex, false);
+    if (entry != nullptr)
+    {
+        ChipLogProgress(SecureChannel, "Resumption stats for removed fabric 0x%02x: %u resumed, %u full CASE", fabricIndex,
+                        static_cast<unsigned>(entry->resumed), static_cast<unsigned>(entry->fullCase));
+        *entry = FabricStats{};
+    }
+    if (mLookedUpNode.GetFabricIndex() == fabricIndex)
+    {
+        Forget();
+    }
+
+    sStats.deletes++;
+    return mInner->DeleteAll(fabricIndex);
+}
+
+} // namespace
+
+SessionResumptionStorage * Wrap(SessionResumptionStorage * inner)
+{
+    VerifyOrReturnValue(inner != nullptr, inner);
+    sStorage.SetInner(inner);
+    return &sStorage;
+}
+
+Stats GetStats()
+{
+    return sStats;
+}
+
+size_t GetFabricStats(FabricStats * out, size_t maxCount)
+{
+    size_t count = 0;
+    for (const FabricStats & entry : sFabricStats)
+    {
+        if (entry.fabricIndex != chip::kUndefinedFabricIndex && count < maxCount)
+        {
+            out[count++] = entry;
+        }
+    }
+    return count;
+}
+
+void LogStats()
+{
+    ChipLogProgress(SecureChannel, "Session resumption: %u saves, %u unknown IDs, %u fabric wipes",
+                    static_cast<unsigned>(sStats.saves), static_cast<unsigned>(sStats.unknownIds),
+                    static_cast<unsigned>(sStats.deletes));
+    for (const FabricStats & entry : sFabricStats)
+    {
+        if (entry.fabricIndex != chip::kUndefinedFabricIndex)
+        {
+            ChipLogProgress(SecureChannel, "  fabric 0x%02x: %u resumed, %u full CASE", entry.fabricIndex,
+                            static_cast<unsigned>(entry.resumed), static_cast<unsigned>(entry.fullCase));
+        }
+    }
+}
+
+} // namespace session_resumption
+} // namespace matter
@@ -0,0 +1,269 @@
+#include "matter/time_service.h"
+
+#include "cfg/settings_writeback.h"
+
+#include <app/server/Server.h>
+#include <lib/core/ErrorStr.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TimeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <system/SystemClock.h>
+#include <zephyr/settings/settings.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace matter
+{
+namespace time_service
+{
+
+namespace
+{
+
+// Syncs closer together than this are dominated by network latency, not RTC drift.
+constexpr uint64_t kMinDriftWindowUs = 10ull * 60 * chip::kMicrosecondsPerSecond;
+// Crystal tolerance plus temperature; anything larger is a bad sample, not drift.
+constexpr int64_t kMaxDriftPpb       = 200000;
+constexpr int64_t kPpbScale          = 1000000000;
+constexpr uint32_t kClockResyncMs    = 60 * 60 * 1000;
+constexpr uint64_t kPersistIntervalUs =
+    static_cast<uint64_t>(CONFIG_SOIL_TIME_PERSIST_INTERVAL_HOURS) * 3600 * chip::kMicrosecondsPerSecond;
+
+constexpr char kSettingsKey[]       = "soil/time";
+constexpr uint8_t kPersistedVersion = 1;
+
+struct PersistedTime
+{
+    uint8_t version;
+    uint8_t hasDrift;
+    uint16_t reserved;
+    int32_t driftPpb;
+    uint64_t utcUs;
+};
+
+Anchor sAnchor            = {};
+bool sHasAnchor           = false;
+bool sRestored            = false;
+int64_t sDriftPpb         = 0;
+bool sHasDrift            = false;
+bool sPersistedThisBoot   = false;
+uint64_t sLastPersistMono = 0;
+
+uint64_t MonotonicNowUs()
+{
+    return chip::System::SystemClock().GetMonotonicMicroseconds64().count();
+}
+
+int64_t ScaleByDrift(int64_t deltaUs)
+{
+    // deltaUs * ppb / 1e9 without overflowing for multi-year deltas.
+    return (deltaUs / 1000) * sDriftPpb / (kPpbScale / 1000);
+}
+
+void UpdateDrift(const Anchor & next)
+{
+    if (!sHasAnchor || next.monotonicUs <= sAnchor.monotonicUs)
+    {
+        return;
+    }
+
+    const uint64_t elapsedUs = next.monotonicUs - sAnchor.monotonicUs;
+    if (elapsedUs < kMinDriftWindowUs)
+    {
+        return;
+    }
+
+    // Compare against the uncorrected prediction so each sample measures the raw RTC rate.
+    const int64_t errorUs   = static_cast<int64_t>(next.utcUs - sAnchor.utcUs) - static_cast<int64_t>(elapsedUs);
+    const int64_t samplePpb = errorUs * (kPpbScale / 1000) / static_cast<int64_t>(elapsedUs / 1000);
+    if (samplePpb > kMaxDriftPpb || samplePpb < -kMaxDriftPpb)
+    {
+        ChipLogProgress(Zcl, "TimeSync: ignoring drift sample %lld ppb", static_cast<long long>(samplePpb));
+        return;
+    }
+
+    sDriftPpb = sHasDrift ? sDriftPpb + (samplePpb - sDriftPpb) / 4 : samplePpb;
+    sHasDrift = true;
+}
+
+void Persist()
+{
+    const uint64_t now = MonotonicNowUs();
+    if (sPersistedThisBoot && (now - sLastPersistMono) < kPersistIntervalUs)
+    {
+        return;
+    }
+
+    PersistedTime record = {};
+    record.version       = kPersistedVersion;
+    record.hasDrift      = sHasDrift ? 1 : 0;
+    record.driftPpb      = static_cast<int32_t>(sDriftPpb);
+    if (MonotonicToUtc(now, record.utcUs) != CHIP_NO_ERROR)
+    {
+        return;
+    }
+
+    int rc = cfg::settings_writeback::Write(kSettingsKey, &record, sizeof(record));
+    if (rc != 0)
+    {
+        ChipLogError(Zcl, "TimeSync: failed to persist UTC anchor: %d", rc);
+        return;
+    }
+
+    sPersistedThisBoot = true;
+    sLastPersistMono   = now;
+}
+
+int LoadPersisted(const char * key, size_t len, settings_read_cb readCb, void * cbArg, void * param)
+{
+    auto * record = static_cast<PersistedTime *>(param);
+    if (key != nullptr || len != sizeof(*record))
+    {
+        return 0;
+    }
+
+    if (readCb(cbArg, record, sizeof(*record)) != static_cast<ssize_t>(sizeof(*record)))
+    {
+        memset(record, 0, sizeof(*record));
+    }
+    return 0;
+}
+
+void Restore()
+{
+    PersistedTime record = {};
+    (void) settings_load_subtree_direct(kSettingsKey, LoadPersisted, &record);
+
+    uint64_t utcUs = (record.version == kPersistedVersion) ? record.utcUs : 0;
+
+    // The stored anchor may be up to one persist interval old; Last Known Good Time can be newer.
+    chip::System::Clock::Seconds32 lkgTime;
+    if (chip::Server::GetInstance().GetFabricTable().GetLastKnownGoodChipEpochTime(lkgTime) == CHIP_NO_ERROR)
+    {
+        utcUs = std::max(utcUs, static_cast<uint64_t>(lkgTime.count()) * chip::kMicrosecondsPerSecond);
+    }
+
+    if (utcUs == 0)
+    {
+        return;
+    }
+
+    sAnchor    = Anchor{ MonotonicNowUs(), utcUs };
+    sHasAnchor = true;
+    sRestored  = true;
+    if (record.version == kPersistedVersion && record.hasDrift != 0)
+    {
+        sDriftPpb = record.driftPpb;
+        sHasDrift = true;
+    }
+
+    ChipLogProgress(Zcl, "TimeSync: restored UTC anchor (unverified), drift %lld ppb", static_cast<long long>(sDriftPpb));
+}
+
+void ApplyToSystemClock()
+{
+    uint64_t chipEpochUs = 0;
+    uint64_t unixEpochUs = 0;
+    if (GetUtcNow(chipEpochUs) != CHIP_NO_ERROR || !chip::ChipEpochToUnixEpochMicros(chipEpochUs, unixEpochUs))
+    {
+        return;
+    }
+
+    CHIP_ERROR err = chip::System::SystemClock().SetClock_RealTime(chip::System::Clock::Microseconds64(unixEpochUs));
+    if (err != CHIP_NO_ERROR && err != CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE)
+    {
+        ChipLogError(Zcl, "TimeSync: failed to update real-time clock: %s", chip::ErrorStr(err));
+    }
+}
+
+void ClockResyncTimer(chip::System::Layer * layer, void *)
+{
+    // The platform real-time clock free-runs on the monotonic timer; fold the drift estimate back in.
+    // A restored anchor is never written back as if it were fresh.
+    if (!sRestored)
+    {
+        ApplyToSystemClock();
+        Persist();
+    }
+    (void) layer->StartTimer(chip::System::Clock::Milliseconds32(kClockResyncMs), ClockResyncTimer, nullptr);
+}
+
+} // namespace
+
+void Init()
+{
+    sHasAnchor         = false;
+    sRestored          = false;
+    sHasDrift          = false;
+    sDriftPpb          = 0;
+    sPersistedThisBoot = false;
+
+    // A restored anchor only timestamps app data. It is deliberately not pushed into the platform
+    // real-time clock, where a stale value could fail certificate validity checks during CASE, and
+    // the resync timer only starts once SetUtcTime() provides a real one.
+    Restore();
+}
+
+void SetUtcTime(uint64_t chipEpochUs)
+{
+    const Anchor next{ MonotonicNowUs(), chipEpochUs };
+
+    // A restored anchor spans an unknown power-off gap, so it cannot seed a drift sample.
+    if (!sRestored)
+    {
+        UpdateDrift(next);
+    }
+    sAnchor    = next;
+    sHasAnchor = true;
+    sRestored  = false;
+
+    ChipLogProgress(Zcl, "TimeSync: anchored UTC, drift %lld ppb", static_cast<long long>(sDriftPpb));
+
+    ApplyToSystemClock();
+    Persist();
+    chip::DeviceLayer::SystemLayer().CancelTimer(ClockResyncTimer, nullptr);
+    (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(kClockResyncMs), ClockResyncTimer,
+                                                       nullptr);
+}
+
+bool HasTime()
+{
+    return sHasAnchor;
+}
+
+bool IsRestored()
+{
+    return sRestored;
+}
+
+CHIP_ERROR GetUtcNow(uint64_t & chipEpochUs)
+{
+    return MonotonicToUtc(MonotonicNowUs(), chipEpochUs);
+}
+
+CHIP_ERROR MonotonicToUtc(uint64_t monotonicUs, uint64_t & chipEpochUs)
+{
+    VerifyOrReturnError(sHasAnchor, CHIP_ERROR_INCORRECT_STATE);
+
+    const int64_t deltaUs   = static_cast<int64_t>(monotonicUs - sAnchor.monotonicUs);
+    const int64_t correctUs = deltaUs + ScaleByDrift(deltaUs);
+    VerifyOrReturnError(correctUs >= 0 || static_cast<uint64_t>(-correctUs) <= sAnchor.utcUs, CHIP_ERROR_INVALID_ARGUMENT);
+
+    chipEpochUs = sAnchor.utcUs + static_cast<uint64_t>(correctUs);
+    return CHIP_NO_ERROR;
+}
+
+Anchor GetAnchor()
+{
+    return sAnchor;
+}
+
+int32_t GetDriftPpb()
+{
+    return static_cast<int32_t>(sDriftPpb);
+}
+
+} // namespace time_service
+} // namespace matter
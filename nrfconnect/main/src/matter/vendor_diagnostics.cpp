@@ -0,0 +1,97 @@
+#include "matter/vendor_diagnostics.h"
+
+#include <access/Privilege.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <lib/support/CodeUtils.h>
+
+namespace matter
+{
+namespace vendor_diagnostics
+{
+
+namespace
+{
+
+constexpr chip::EndpointId kRootEndpoint = 0;
+constexpr chip::ClusterId kClusterId     = chip::app::Clusters::GeneralDiagnostics::Id;
+
+struct Entry
+{
+    chip::AttributeId attributeId;
+    Snapshot snapshot;
+};
+
+Entry sEntries[kMaxAttributes];
+size_t sEntryCount = 0;
+
+bool IsVendorCluster(chip::EndpointId endpoint, chip::ClusterId cluster)
+{
+    return endpoint == kRootEndpoint && cluster == kClusterId;
+}
+
+const Entry * FindEntry(chip::AttributeId attributeId)
+{
+    for (size_t i = 0; i < sEntryCount; ++i)
+    {
+        if (sEntries[i].attributeId == attributeId)
+        {
+            return &sEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+CHIP_ERROR Register(chip::AttributeId attributeId, Snapshot snapshot)
+{
+    VerifyOrReturnError(snapshot != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(FindEntry(attributeId) == nullptr, CHIP_ERROR_DUPLICATE_KEY_ID);
+    VerifyOrReturnError(sEntryCount < kMaxAttributes, CHIP_ERROR_NO_MEMORY);
+
+    sEntries[sEntryCount++] = Entry{ attributeId, snapshot };
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AppendAttributes(const chip::app::ConcreteClusterPath & path,
+                            chip::ReadOnlyBufferBuilder<chip::app::DataModel::AttributeEntry> & builder)
+{
+    if (!IsVendorCluster(path.mEndpointId, path.mClusterId) || sEntryCount == 0)
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    ReturnErrorOnFailure(builder.EnsureAppendCapacity(sEntryCount));
+    for (size_t i = 0; i < sEntryCount; ++i)
+    {
+        ReturnErrorOnFailure(builder.Append(chip::app::DataModel::AttributeEntry(
+            sEntries[i].attributeId, {}, chip::Access::Privilege::kView, std::nullopt)));
+    }
+    return CHIP_NO_ERROR;
+}
+
+bool TryRead(const chip::app::ConcreteAttributePath & path, chip::app::AttributeValueEncoder & encoder, CHIP_ERROR & err)
+{
+    if (!IsVendorCluster(path.mEndpointId, path.mClusterId))
+    {
+        return false;
+    }
+
+    const Entry * entry = FindEntry(path.mAttributeId);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    uint8_t buffer[kMaxValueSize];
+    chip::MutableByteSpan value(buffer);
+    err = entry->snapshot(value);
+    if (err == CHIP_NO_ERROR)
+    {
+        err = encoder.Encode(chip::ByteSpan(value));
+    }
+    return true;
+}
+
+} // namespace vendor_diagnostics
+} // namespace matter
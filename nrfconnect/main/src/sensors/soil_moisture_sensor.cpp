@@ -3,6 +3,11 @@
 #include <zephyr/sys/util.h>
 
 #if IS_ENABLED(CONFIG_SOIL_ENDPOINT)
+#include "connectivity/thread_sed.h"
+#include "connectivity/wifi_power_policy.h"
+#include "matter/report_cache.h"
+#include "sensors/soil_threshold_events.h"
+
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/clusters/soil-measurement-server/soil-measurement-cluster.h>
 #include <app/server-cluster/ServerClusterInterfaceRegistry.h>
@@ -25,11 +30,25 @@ namespace
 
 static chip::app::LazyRegisteredServerCluster<chip::app::Clusters::SoilMeasurementCluster> sSoilCluster;
 constexpr chip::EndpointId kSoilEndpoint = 1;
-constexpr uint32_t kSoilUpdateMs         = 5000;
+constexpr uint32_t kSoilUpdateMs         = CONFIG_SOIL_SAMPLE_INTERVAL_MS;
 uint8_t gSoilLast                        = 101; // invalid sentinel so first update always changes
 
+const chip::app::ConcreteAttributePath kMeasuredValuePath(
+    kSoilEndpoint, chip::app::Clusters::SoilMeasurement::Id,
+    chip::app::Clusters::SoilMeasurement::Attributes::SoilMoistureMeasuredValue::Id);
+
+chip::DataVersion SoilClusterDataVersion()
+{
+    return sSoilCluster.Cluster().GetDataVersion(
+        chip::app::ConcreteClusterPath(kSoilEndpoint, chip::app::Clusters::SoilMeasurement::Id));
+}
+
 void SoilUpdateTimer(chip::System::Layer * layer, void *)
 {
+    // Keep the radio awake while the resulting reports and their acks go out.
+    connectivity::wifi_power_policy::BeginBurst();
+    connectivity::thread_sed::BeginBurst();
+
     uint8_t v = static_cast<uint8_t>(chip::Crypto::GetRandU16() % 101);
     if (v == gSoilLast)
     {
@@ -38,6 +57,9 @@ void SoilUpdateTimer(chip::System::Layer * layer, void *)
     chip::app::DataModel::Nullable<chip::Percent> measured;
     measured.SetNonNull(v);
     (void) sSoilCluster.Cluster().SetSoilMoistureMeasuredValue(measured);
+    // Encode once here; every subscription reporting this change copies the cached element.
+    (void) matter::report_cache::Store(kMeasuredValuePath, measured);
+    sensors::soil_threshold_events::OnMeasurement(kSoilEndpoint, v);
     gSoilLast = v;
     if (layer)
     {
@@ -72,6 +94,8 @@ void Init()
 
     sSoilCluster.Create(kSoilEndpoint, limits);
     (void) chip::app::CodegenDataModelProvider::Instance().Registry().Register(sSoilCluster.Registration());
+    (void) matter::report_cache::RegisterAttribute(kMeasuredValuePath, SoilClusterDataVersion);
+    sensors::soil_threshold_events::Init();
 
     SoilUpdateTimer(nullptr, nullptr);
     (void) chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(kSoilUpdateMs), SoilUpdateTimer, nullptr);
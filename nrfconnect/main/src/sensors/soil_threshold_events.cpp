@@ -0,0 +1,153 @@
+#include "sensors/soil_threshold_events.h"
+
+#include <app/EventLogging.h>
+#include <lib/core/ErrorStr.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <zephyr/logging/log.h>
+
+#include <cinttypes>
+
+LOG_MODULE_DECLARE(soil_app, LOG_LEVEL_INF);
+
+namespace sensors
+{
+namespace soil_threshold_events
+{
+
+namespace
+{
+
+enum class Band : uint8_t
+{
+    Unknown = 0,
+    Normal,
+    Dry,
+    Wet,
+};
+
+struct ThresholdCrossedEvent
+{
+    static constexpr chip::app::PriorityLevel kPriorityLevel = chip::app::PriorityLevel::Info;
+    static constexpr bool kIsFabricScoped                     = false;
+
+    enum class Fields : uint8_t
+    {
+        kMeasuredValue = 0,
+        kThreshold     = 1,
+        kEntered       = 2,
+    };
+
+    chip::EventId eventId;
+    chip::Percent measuredValue;
+    chip::Percent threshold;
+    bool entered;
+
+    chip::app::PriorityLevel GetPriorityLevel() const { return kPriorityLevel; }
+    chip::EventId GetEventId() const { return eventId; }
+    chip::ClusterId GetClusterId() const { return kClusterId; }
+    chip::FabricIndex GetFabricIndex() const { return chip::kUndefinedFabricIndex; }
+
+    CHIP_ERROR Encode(chip::TLV::TLVWriter & writer, chip::TLV::Tag tag) const
+    {
+        chip::TLV::TLVType outer;
+        ReturnErrorOnFailure(writer.StartContainer(tag, chip::TLV::kTLVType_Structure, outer));
+        ReturnErrorOnFailure(writer.Put(chip::TLV::ContextTag(Fields::kMeasuredValue), measuredValue));
+        ReturnErrorOnFailure(writer.Put(chip::TLV::ContextTag(Fields::kThreshold), threshold));
+        ReturnErrorOnFailure(writer.PutBoolean(chip::TLV::ContextTag(Fields::kEntered), entered));
+        return writer.EndContainer(outer);
+    }
+};
+
+constexpr uint8_t kDryThreshold = CONFIG_SOIL_DRY_THRESHOLD_PERCENT;
+constexpr uint8_t kWetThreshold = CONFIG_SOIL_WET_THRESHOLD_PERCENT;
+static_assert(kDryThreshold < kWetThreshold, "CONFIG_SOIL_DRY_THRESHOLD_PERCENT must be below the wet threshold");
+
+Band sBand = Band::Unknown;
+
+Band Classify(uint8_t percent, Band current)
+{
+    constexpr uint8_t kHysteresis = CONFIG_SOIL_THRESHOLD_HYSTERESIS_PERCENT;
+
+    // Stay in a crossed band until the value has moved back past the hysteresis margin.
+    if (current == Band::Dry && percent <= kDryThreshold + kHysteresis)
+    {
+        return Band::Dry;
+    }
+    if (current == Band::Wet && percent + kHysteresis >= kWetThreshold)
+    {
+        return Band::Wet;
+    }
+
+    if (percent <= kDryThreshold)
+    {
+        return Band::Dry;
+    }
+    if (percent >= kWetThreshold)
+    {
+        return Band::Wet;
+    }
+    return Band::Normal;
+}
+
+void Emit(chip::EndpointId endpoint, chip::EventId eventId, uint8_t percent, uint8_t threshold, bool entered)
+{
+    ThresholdCrossedEvent event{ eventId, percent, threshold, entered };
+    chip::EventNumber eventNumber = 0;
+
+    CHIP_ERROR err = chip::app::LogEvent(event, endpoint, eventNumber);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Soil threshold event 0x%08" PRIx32 " not logged: %s", eventId, chip::ErrorStr(err));
+        return;
+    }
+
+    LOG_INF("Soil %s threshold %s at %u%% (event #%" PRIu64 ")", (eventId == kDryThresholdCrossed) ? "dry" : "wet",
+            entered ? "entered" : "left", percent, static_cast<uint64_t>(eventNumber));
+}
+
+} // namespace
+
+void Init()
+{
+    sBand = Band::Unknown;
+}
+
+void OnMeasurement(chip::EndpointId endpoint, uint8_t percent)
+{
+    const Band next = Classify(percent, sBand);
+    const Band prev = sBand;
+    sBand           = next;
+
+    if (prev == Band::Unknown || prev == next)
+    {
+        return;
+    }
+
+    if (prev == Band::Dry)
+    {
+        Emit(endpoint, kDryThresholdCrossed, percent, kDryThreshold, false);
+    }
+    else if (prev == Band::Wet)
+    {
+        Emit(endpoint, kWetThresholdCrossed, percent, kWetThreshold, false);
+    }
+
+    if (next == Band::Dry)
+    {
+        Emit(endpoint, kDryThresholdCrossed, percent, kDryThreshold, true);
+    }
+    else if (next == Band::Wet)
+    {
+        Emit(endpoint, kWetThresholdCrossed, percent, kWetThreshold, true);
+    }
+}
+
+bool IsThresholdEvent(const chip::app::ConcreteEventPath & path)
+{
+    return path.mClusterId == kClusterId && (path.mEventId == kDryThresholdCrossed || path.mEventId == kWetThresholdCrossed);
+}
+
+} // namespace soil_threshold_events
+} // namespace sensors
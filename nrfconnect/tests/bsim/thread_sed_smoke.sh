@@ -0,0 +1,65 @@
+#!/usr/bin/env bash
+#
+#    Copyright (c) 2024 Project CHIP Authors
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+# Smoke test for the Thread sleepy end device variant on a simulated radio (Linux):
+# builds prj_thread_sed.conf for nrf52_bsim, runs it against the BabbleSim 2.4 GHz phy for
+# SIM_SECONDS of simulated time and checks that it booted, brought OpenThread up as a sleepy end
+# device, left the MRP intervals to the ICD manager and never hit a fatal error.
+#
+# Needs an nRF Connect SDK workspace (ZEPHYR_BASE) and BabbleSim (BSIM_OUT_PATH, BSIM_COMPONENTS_PATH).
+#   tests/bsim/thread_sed_smoke.sh [build-dir]
+
+set -eu
+
+: "${ZEPHYR_BASE:?ZEPHYR_BASE must point at the Zephyr tree}"
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH must point at the BabbleSim install}"
+
+APP_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+BUILD_DIR="${1:-${APP_DIR}/build_bsim_thread_sed}"
+SIM_ID="soil_thread_sed_smoke_$$"
+SIM_SECONDS="${SIM_SECONDS:-30}"
+LOG_FILE="${BUILD_DIR}/smoke.log"
+
+west build -p auto -b nrf52_bsim --no-sysbuild -d "${BUILD_DIR}" "${APP_DIR}" -- -DFILE_SUFFIX=thread_sed
+
+cd "${BSIM_OUT_PATH}/bin"
+./bs_2G4_phy_v1 -s="${SIM_ID}" -D=1 -sim_length="${SIM_SECONDS}e6" >/dev/null &
+PHY_PID=$!
+"${BUILD_DIR}/zephyr/zephyr.exe" -s="${SIM_ID}" -d=0 >"${LOG_FILE}" 2>&1 || true
+wait "${PHY_PID}" || true
+
+status=0
+for expected in "Soil sensor app started" "Thread stack up as sleepy end device" \
+    "MRP intervals follow the ICD poll periods" "Boot total"; do
+    if ! grep -q "${expected}" "${LOG_FILE}"; then
+        echo "FAIL: missing \"${expected}\"" >&2
+        status=1
+    fi
+done
+for unexpected in "ZEPHYR FATAL ERROR" "ASSERTION FAIL"; do
+    if grep -q "${unexpected}" "${LOG_FILE}"; then
+        echo "FAIL: found \"${unexpected}\"" >&2
+        status=1
+    fi
+done
+
+if [ "${status}" -eq 0 ]; then
+    echo "PASS: Thread SED smoke test (${SIM_SECONDS} s simulated)"
+else
+    echo "Device log: ${LOG_FILE}" >&2
+fi
+exit "${status}"
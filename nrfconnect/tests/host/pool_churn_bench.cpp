@@ -0,0 +1,353 @@
+// Host benchmark for the per-transaction object pools (CHIPProjectConfig.h, diag/pool_stats.h):
+// subscription churn served from a shared general-purpose heap, as with
+// CHIP_SYSTEM_CONFIG_POOL_USE_HEAP=1, against the same churn served from fixed bitmap pools.
+//
+// The heap is a first-fit allocator with coalescing over an arena the size of the release
+// CONFIG_CHIP_MALLOC_SYS_HEAP_SIZE, standing in for the Zephyr sys_heap behind the CHIP heap. The
+// pools follow the SDK's BitMapObjectPool: one bit per slot, first free bit wins. In both variants
+// the rest of the stack keeps allocating variable-sized, partly long-lived blocks from the heap,
+// which is what fragments it. Both variants get the same number of bytes: the heap-only arena is
+// grown by the pool footprint. Failures of the background blocks are reported apart from failures
+// of the pooled object types. Object and background sizes are rough 32-bit estimates: the timing
+// does not depend on them being exact, the background failures do.
+//
+//   pool_churn_bench [iterations] [seed]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t kHeapSize        = 14336; // prj_release.conf CONFIG_CHIP_MALLOC_SYS_HEAP_SIZE
+constexpr size_t kFabrics         = 5;     // CONFIG_CHIP_MAX_FABRICS
+constexpr size_t kSubsPerFabric   = 3;
+constexpr size_t kReportsInFlight = 4;
+
+constexpr size_t kReadHandlerSize  = 420;
+constexpr size_t kExchangeSize     = 160;
+constexpr size_t kPacketBufferSize = 1280 + 32;
+
+constexpr size_t kSubscriptions = kFabrics * kSubsPerFabric;
+constexpr size_t kReads         = kFabrics + 1;
+constexpr size_t kExchanges     = kReads + kReportsInFlight + kFabrics;
+constexpr size_t kPacketBuffers = kReportsInFlight + kFabrics + 2 + 3;
+constexpr size_t kHandlers      = kSubscriptions + kReads;
+
+constexpr size_t kPoolBytes =
+    kHandlers * kReadHandlerSize + kExchanges * kExchangeSize + kPacketBuffers * kPacketBufferSize;
+
+// First-fit heap with an 8-byte header per block; free blocks are coalesced with their neighbours.
+template <size_t kSize>
+class ArenaHeap
+{
+public:
+    ArenaHeap()
+    {
+        Header * first = At(0);
+        first->size    = kSize;
+        first->used    = 0;
+    }
+
+    void * Alloc(size_t size)
+    {
+        const uint32_t need = static_cast<uint32_t>(Round(size + sizeof(Header)));
+        for (uint32_t offset = 0; offset < kSize; offset += At(offset)->size)
+        {
+            Header * block = At(offset);
+            if (block->used || block->size < need)
+            {
+                continue;
+            }
+            if (block->size - need >= kMinSplit)
+            {
+                Header * rest = At(offset + need);
+                rest->size    = block->size - need;
+                rest->used    = 0;
+                block->size   = need;
+            }
+            block->used = 1;
+            mUsed += block->size;
+            return block + 1;
+        }
+        return nullptr;
+    }
+
+    void Free(void * ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        Header * block = static_cast<Header *>(ptr) - 1;
+        block->used    = 0;
+        mUsed -= block->size;
+        Coalesce();
+    }
+
+    size_t LargestFree() const
+    {
+        size_t largest = 0;
+        for (uint32_t offset = 0; offset < kSize; offset += At(offset)->size)
+        {
+            if (!At(offset)->used)
+            {
+                largest = std::max<size_t>(largest, At(offset)->size - sizeof(Header));
+            }
+        }
+        return largest;
+    }
+
+    size_t Free() const { return kSize - mUsed; }
+
+private:
+    struct Header
+    {
+        uint32_t size; // including the header
+        uint32_t used;
+    };
+
+    static constexpr uint32_t kMinSplit = 32;
+
+    static size_t Round(size_t size) { return (size + 7) & ~size_t(7); }
+
+    Header * At(uint32_t offset) { return reinterpret_cast<Header *>(mArena + offset); }
+    const Header * At(uint32_t offset) const { return reinterpret_cast<const Header *>(mArena + offset); }
+
+    void Coalesce()
+    {
+        for (uint32_t offset = 0; offset < kSize; offset += At(offset)->size)
+        {
+            Header * block = At(offset);
+            while (!block->used && offset + block->size < kSize && !At(offset + block->size)->used)
+            {
+                block->size += At(offset + block->size)->size;
+            }
+        }
+    }
+
+    alignas(8) uint8_t mArena[kSize];
+    size_t mUsed = 0;
+};
+
+// Fixed slots with a free bitmap, like chip::BitMapObjectPool.
+template <size_t kSize, size_t kCount>
+class BitmapPool
+{
+public:
+    void * Alloc()
+    {
+        for (size_t word = 0; word < kWords; ++word)
+        {
+            if (mBits[word] == UINT32_MAX)
+            {
+                continue;
+            }
+            const size_t bit   = static_cast<size_t>(__builtin_ctz(~mBits[word]));
+            const size_t index = word * 32 + bit;
+            if (index >= kCount)
+            {
+                break;
+            }
+            mBits[word] |= (1u << bit);
+            return mSlots[index];
+        }
+        return nullptr;
+    }
+
+    void Free(void * ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        const size_t index = static_cast<size_t>(static_cast<uint8_t(*)[kSize]>(ptr) - mSlots);
+        mBits[index / 32] &= ~(1u << (index % 32));
+    }
+
+private:
+    static constexpr size_t kWords = (kCount + 31) / 32;
+
+    alignas(8) uint8_t mSlots[kCount][kSize];
+    uint32_t mBits[kWords] = {};
+};
+
+struct Result
+{
+    double nsPerCycle;
+    uint32_t objectFailures;     // read handlers, exchanges and packet buffers
+    uint32_t backgroundFailures; // the rest of the stack's heap blocks
+    size_t minLargestFree;
+    size_t endLargestFree;
+    size_t endFree;
+};
+
+struct Subscription
+{
+    void * handler = nullptr;
+};
+
+// The rest of the stack: sessions, TLV scratch and certificates. Roughly 12 KB stays allocated,
+// with one block replaced per step.
+struct Background
+{
+    static constexpr size_t kBlocks = 36;
+
+    std::vector<void *> live;
+    uint32_t failures = 0;
+
+    template <typename Heap>
+    void Step(Heap & heap, std::mt19937 & rng)
+    {
+        std::uniform_int_distribution<size_t> size(24, 640);
+        if (live.size() >= kBlocks)
+        {
+            const size_t index = rng() % live.size();
+            heap.Free(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+        void * block = heap.Alloc(size(rng));
+        if (block == nullptr)
+        {
+            failures++;
+            return;
+        }
+        live.push_back(block);
+    }
+};
+
+// One churn cycle: a subscription is torn down and re-established (read handler, exchange, priming
+// report waiting for its ack), while reports to the other subscribers come and go.
+template <typename Heap, typename Alloc, typename Free>
+Result Run(uint32_t iterations, uint32_t seed, Heap & heap, Alloc && allocObject, Free && release)
+{
+    std::mt19937 rng(seed);
+    Background background;
+    Subscription subs[kSubscriptions];
+    Result result         = {};
+    result.minLargestFree = SIZE_MAX;
+
+    auto alloc = [&](size_t size) {
+        void * ptr = allocObject(size);
+        if (ptr == nullptr)
+        {
+            result.objectFailures++;
+        }
+        return ptr;
+    };
+
+    for (Subscription & sub : subs)
+    {
+        sub.handler = alloc(kReadHandlerSize);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        Subscription & sub = subs[rng() % kSubscriptions];
+        release(sub.handler, kReadHandlerSize);
+        background.Step(heap, rng);
+
+        void * exchange = alloc(kExchangeSize);
+        sub.handler     = alloc(kReadHandlerSize);
+        void * report   = alloc(kPacketBufferSize);
+        void * reports[kReportsInFlight - 1];
+        for (void *& buffer : reports)
+        {
+            buffer = alloc(kPacketBufferSize);
+        }
+        background.Step(heap, rng);
+
+        for (void * buffer : reports)
+        {
+            release(buffer, kPacketBufferSize);
+        }
+        release(report, kPacketBufferSize);
+        release(exchange, kExchangeSize);
+
+        if ((i & 0xff) == 0)
+        {
+            result.minLargestFree = std::min(result.minLargestFree, heap.LargestFree());
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.nsPerCycle         = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    result.backgroundFailures = background.failures;
+    result.endLargestFree = heap.LargestFree();
+    result.endFree        = heap.Free();
+    return result;
+}
+
+void Print(const char * name, const Result & result)
+{
+    printf("%-6s %10.1f %15u %19u %17zu %17zu %9zu\n", name, result.nsPerCycle, result.objectFailures,
+           result.backgroundFailures, result.minLargestFree, result.endLargestFree, result.endFree);
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    const uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : 200000;
+    const uint32_t seed       = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : 1;
+    if (iterations == 0)
+    {
+        fprintf(stderr, "usage: %s [iterations] [seed]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%u churn cycles, %zu subscriptions, %zu B total: heap only, or %zu B heap + %zu B pools "
+           "(%zu handlers, %zu exchanges, %zu packet buffers)\n",
+           iterations, kSubscriptions, kHeapSize + kPoolBytes, kHeapSize, kPoolBytes, kHandlers, kExchanges,
+           kPacketBuffers);
+    printf("%-6s %10s %15s %19s %17s %17s %9s\n", "", "ns/cycle", "objects failed", "background failed",
+           "min largest free", "end largest free", "end free");
+
+    static ArenaHeap<kHeapSize + kPoolBytes> heapOnly;
+    Result heap = Run(iterations, seed, heapOnly, [](size_t size) { return heapOnly.Alloc(size); },
+                      [](void * ptr, size_t) { heapOnly.Free(ptr); });
+    Print("heap", heap);
+
+    static ArenaHeap<kHeapSize> background;
+    static BitmapPool<kReadHandlerSize, kHandlers> handlers;
+    static BitmapPool<kExchangeSize, kExchanges> exchanges;
+    static BitmapPool<kPacketBufferSize, kPacketBuffers> buffers;
+    Result pool = Run(
+        iterations, seed, background,
+        [](size_t size) -> void * {
+            switch (size)
+            {
+            case kReadHandlerSize:
+                return handlers.Alloc();
+            case kExchangeSize:
+                return exchanges.Alloc();
+            default:
+                return buffers.Alloc();
+            }
+        },
+        [](void * ptr, size_t size) {
+            switch (size)
+            {
+            case kReadHandlerSize:
+                handlers.Free(ptr);
+                break;
+            case kExchangeSize:
+                exchanges.Free(ptr);
+                break;
+            default:
+                buffers.Free(ptr);
+                break;
+            }
+        });
+    Print("pool", pool);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+#
+#    Copyright (c) 2024 Project CHIP Authors
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+# Builds and runs the host benchmark comparing heap-backed and pooled per-transaction objects under
+# subscription churn (pool_churn_bench.cpp). Needs only a host C++17 compiler.
+#   tests/host/pool_churn_bench.sh [iterations] [seed]
+
+set -eu
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${BUILD_DIR:-${HERE}/../../build/host}"
+
+mkdir -p "${BUILD_DIR}"
+"${CXX:-c++}" -std=c++17 -O2 -Wall -Wextra -o "${BUILD_DIR}/pool_churn_bench" "${HERE}/pool_churn_bench.cpp"
+"${BUILD_DIR}/pool_churn_bench" "$@"